@@ -1,4 +1,5 @@
 #include "UISystem.h"
+#include "profiler.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -21,6 +22,8 @@ void ui_exit(UIData* uiData) {
 }
 
 void ui_tick(UIData* uiData) {
+	PROFILE_BEGIN(PROFILE_ZONE_UI_TICK);
+
 	Vector2 mousePos = GetMousePosition();
 	bool isMouseReleased = IsMouseButtonReleased(0);
 
@@ -43,18 +46,25 @@ void ui_tick(UIData* uiData) {
 			text->ColorIndex = uiData->ButtonsEnabled[i].ColorTextDefault; 
 		}
 	}
+
+	PROFILE_END(PROFILE_ZONE_UI_TICK);
 }
 
-void ui_draw(UIData* uiData, Color* gameColors) {
+// Rectangles go on the given layer, their text on the layer right above it
+void ui_draw(UIData* uiData, RenderQueue* renderQueue, uint8_t layer) {
+	PROFILE_BEGIN(PROFILE_ZONE_UI_DRAW);
+
 	for (int i = 0; i < uiData->RectangleCount; ++i) {
-		DrawRectangle(uiData->Rectangles[i].PosX, uiData->Rectangles[i].PosY, uiData->Rectangles[i].Width, uiData->Rectangles[i].Height, gameColors[uiData->Rectangles[i].ColorIndex]);
+		render_queue_rect(renderQueue, layer, uiData->Rectangles[i].PosX, uiData->Rectangles[i].PosY, uiData->Rectangles[i].Width, uiData->Rectangles[i].Height, uiData->Rectangles[i].ColorIndex);
 	}
 
-	SetTextLineSpacing(18);
 	for (int i = 0; i < uiData->RectangleCount; ++i) {
-		DrawText(uiData->RectanglesText[i].Text, uiData->RectanglesText[i].PosX, uiData->RectanglesText[i].PosY, uiData->RectanglesText[i].FontSize, gameColors[uiData->RectanglesText[i].ColorIndex]);
+		if (uiData->RectanglesText[i].Text == NULL) continue;
+
+		render_queue_text(renderQueue, layer + 1, uiData->RectanglesText[i].Text, uiData->RectanglesText[i].PosX, uiData->RectanglesText[i].PosY, uiData->RectanglesText[i].FontSize, 18, uiData->RectanglesText[i].ColorIndex);
 	}
-	SetTextLineSpacing(15); // 15 is the default
+
+	PROFILE_END(PROFILE_ZONE_UI_DRAW);
 }
 
 uint16_t ui_add_rectangle(UIData* uiData, uint16_t posX, uint16_t posY, uint16_t width, uint16_t height, uint8_t rectColor) {
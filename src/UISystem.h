@@ -5,6 +5,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "render_queue.h"
+
 #define MAX_RECTANGLES 8
 #define MAX_BUTTONS 5
 
@@ -176,7 +178,7 @@ typedef struct UIData {
 
 void ui_exit(UIData* uiData);
 void ui_tick(UIData* uiData);
-void ui_draw(UIData* uiData, Color* gameColors);
+void ui_draw(UIData* uiData, RenderQueue* renderQueue, uint8_t layer);
 
 uint16_t ui_add_rectangle(UIData* uiData, uint16_t posX, uint16_t posY, uint16_t width, uint16_t height, uint8_t rectColor);
 uint16_t ui_add_rectangle_with_text(UIData* uiData, uint16_t posX, uint16_t posY, uint16_t width, uint16_t height, uint8_t rectColor, const char* text, UIStyleText textStyle);
@@ -1 +1 @@
-emcc -o raylib_game.html raylib_game.c game.c menu_game.c UISystem.c image_color_parser.c level_parser.c particles.c -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Os -I. -I C:/dev/raylib/GameJam/2024_OCT/raylib/src -I C:/dev/raylib/GameJam/2024_OCT/raylib/src/external -L. -L C:/dev/raylib/GameJam/2024_OCT/raylib/src -s USE_GLFW=3 -s FULL_ES3 -s ASSERTIONS -s ASYNCIFY -s ASYNCIFY_STACK_SIZE=1048576 -s TOTAL_MEMORY=128MB -s STACK_SIZE=1MB -s FORCE_FILESYSTEM=1 --preload-file resources --shell-file minshell.html C:/dev/raylib/GameJam/2024_OCT/raylib/src/web/libraylib.a -DPLATFORM_WEB -DDEBUG -s EXPORTED_FUNCTIONS=["_free","_malloc","_main"] -s EXPORTED_RUNTIME_METHODS=ccall
\ No newline at end of file
+emcc -o raylib_game.html raylib_game.c game.c menu_game.c UISystem.c image_color_parser.c level_parser.c parallax.c particles.c job_system.c effects.c render_queue.c sim_thread.c threading.c asset_loader.c asset_pack.c sprite_cache.c sound_pool.c profiler.c -Wall -std=c99 -D_DEFAULT_SOURCE -Wno-missing-braces -Wunused-result -Os -I. -I C:/dev/raylib/GameJam/2024_OCT/raylib/src -I C:/dev/raylib/GameJam/2024_OCT/raylib/src/external -L. -L C:/dev/raylib/GameJam/2024_OCT/raylib/src -s USE_GLFW=3 -s FULL_ES3 -s ASSERTIONS -s ASYNCIFY -s ASYNCIFY_STACK_SIZE=1048576 -s TOTAL_MEMORY=128MB -s STACK_SIZE=1MB -s FORCE_FILESYSTEM=1 --preload-file resources --shell-file minshell.html C:/dev/raylib/GameJam/2024_OCT/raylib/src/web/libraylib.a -DPLATFORM_WEB -DDEBUG -s EXPORTED_FUNCTIONS=["_free","_malloc","_main"] -s EXPORTED_RUNTIME_METHODS=ccall
\ No newline at end of file
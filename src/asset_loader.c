@@ -0,0 +1,351 @@
+#include "asset_loader.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "image_color_parser.h"
+#include "threading.h"
+#include "profiler.h"
+
+#define ASSET_HASH_PRIME 0x100000001b3ull
+#define ASSET_COOKED_MAGIC 0x444b4f43 // "COKD"
+
+// Blob layout: header, then per image an AssetCookedImage followed by its pixels
+typedef struct AssetCookedHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint64_t Key;
+	int32_t ImageCount;
+} AssetCookedHeader;
+
+typedef struct AssetCookedImage {
+	int32_t Width;
+	int32_t Height;
+	int32_t Format;
+	int32_t Mipmaps;
+} AssetCookedImage;
+
+// FNV-1a
+uint64_t asset_hash(uint64_t hash, const void* data, int size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+
+	for (int i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= ASSET_HASH_PRIME;
+	}
+
+	return hash;
+}
+
+uint64_t asset_hash_file(const AssetFile* file, uint64_t hash) {
+	return file->Data != NULL ? asset_hash(hash, file->Data, file->Size) : hash;
+}
+
+// Read by loader threads, only changed before and after loading
+static AssetPack* MountedPack = NULL;
+
+void asset_pack_mount(const char* path) {
+	asset_pack_unmount();
+	MountedPack = asset_pack_open(path);
+
+	if (MountedPack != NULL) {
+		TraceLog(LOG_INFO, "ASSETS: Mounted asset pack %s", path);
+	}
+}
+
+void asset_pack_unmount(void) {
+	asset_pack_close(MountedPack);
+	MountedPack = NULL;
+}
+
+static AssetFile asset_file_open_packed(const char* path) {
+	AssetFile file = { 0 };
+
+	if (MountedPack != NULL) {
+		file.Data = asset_pack_read(MountedPack, path, &file.Size);
+		file.FromPack = file.Data != NULL;
+	}
+
+	return file;
+}
+
+static AssetFile asset_file_open_loose(const char* path) {
+	AssetFile file = { 0 };
+
+	if (FileExists(path)) {
+		unsigned char* data = LoadFileData(path, &file.Size);
+
+		// Same guarantee as pack entries
+		if (data != NULL) {
+			data = RL_REALLOC(data, file.Size + 1);
+			data[file.Size] = '\0';
+		}
+
+		file.Data = data;
+	}
+
+	return file;
+}
+
+AssetFile asset_file_open(const char* path) {
+	AssetFile file = asset_file_open_packed(path);
+
+	if (file.Data == NULL) {
+		file = asset_file_open_loose(path);
+	}
+
+	return file;
+}
+
+void asset_file_close(AssetFile* file) {
+	if (file->FromPack) {
+		asset_pack_release(MountedPack, file->Data);
+	}
+	else {
+		UnloadFileData((unsigned char*)file->Data);
+	}
+
+	*file = (AssetFile){ 0 };
+}
+
+Image asset_image_load(const char* path) {
+	AssetFile file = asset_file_open(path);
+
+	Image image = file.Data != NULL ? LoadImageFromMemory(GetFileExtension(path), file.Data, file.Size) : (Image){ 0 };
+
+	asset_file_close(&file);
+
+	return image;
+}
+
+Sound asset_sound_load(const char* path) {
+	AssetFile file = asset_file_open(path);
+
+	Wave wave = file.Data != NULL ? LoadWaveFromMemory(GetFileExtension(path), file.Data, file.Size) : (Wave){ 0 };
+	Sound sound = LoadSoundFromWave(wave);
+
+	UnloadWave(wave);
+	asset_file_close(&file);
+
+	return sound;
+}
+
+// Music is decoded while it plays, straight from the pack's mapping or streamed from the loose file
+Music asset_music_load(const char* path, AssetFile* file) {
+	*file = (AssetFile){ 0 };
+
+	if (MountedPack != NULL) {
+		file->Data = asset_pack_read(MountedPack, path, &file->Size);
+		file->FromPack = file->Data != NULL;
+	}
+
+	if (file->FromPack) {
+		return LoadMusicStreamFromMemory(GetFileExtension(path), file->Data, file->Size);
+	}
+
+	return LoadMusicStream(path);
+}
+
+static void asset_cache_path(const AssetLoader* loader, uint64_t id, char* path, int size) {
+	snprintf(path, size, "%s/%016llx.cooked", loader->CacheDirectory, (unsigned long long)id);
+}
+
+static bool asset_cache_parse(const AssetFile* file, uint64_t key, Image* images, int imageCount) {
+	const unsigned char* data = file->Data;
+	const int size = file->Size;
+
+	AssetCookedHeader header = { 0 };
+	if (size >= (int)sizeof(header)) {
+		memcpy(&header, data, sizeof(header));
+	}
+
+	bool valid = header.Magic == ASSET_COOKED_MAGIC && header.Version == ASSET_COOK_VERSION
+		&& header.Key == key && header.ImageCount == imageCount;
+
+	int offset = sizeof(header);
+	for (int i = 0; i < imageCount && valid; i++) {
+		AssetCookedImage info = { 0 };
+
+		if (offset + (int)sizeof(info) > size) {
+			valid = false;
+			break;
+		}
+
+		memcpy(&info, data + offset, sizeof(info));
+		offset += sizeof(info);
+
+		const int pixelSize = GetPixelDataSize(info.Width, info.Height, info.Format);
+		if (pixelSize <= 0 || offset + pixelSize > size) {
+			valid = false;
+			break;
+		}
+
+		images[i] = (Image){ RL_MALLOC(pixelSize), info.Width, info.Height, info.Mipmaps, info.Format };
+		memcpy(images[i].data, data + offset, pixelSize);
+		offset += pixelSize;
+	}
+
+	if (!valid) {
+		for (int i = 0; i < imageCount; i++) {
+			RL_FREE(images[i].data);
+			images[i] = (Image){ 0 };
+		}
+	}
+
+	return valid;
+}
+
+// The loose blob comes first: asset_cache_write only ever writes loose files, so after a source or
+// palette change the fresh blob is there while the packed one is stale until the next pack_assets run
+bool asset_cache_read(const AssetLoader* loader, uint64_t id, uint64_t key, Image* images, int imageCount) {
+	if (loader->CacheDirectory == NULL) return false;
+
+	char path[512];
+	asset_cache_path(loader, id, path, sizeof(path));
+
+	AssetFile file = asset_file_open_loose(path);
+	bool valid = file.Data != NULL && asset_cache_parse(&file, key, images, imageCount);
+	asset_file_close(&file);
+
+	if (!valid) {
+		file = asset_file_open_packed(path);
+		valid = file.Data != NULL && asset_cache_parse(&file, key, images, imageCount);
+		asset_file_close(&file);
+	}
+
+	return valid;
+}
+
+void asset_cache_write(const AssetLoader* loader, uint64_t id, uint64_t key, const Image* images, int imageCount) {
+	if (loader->CacheDirectory == NULL) return;
+
+	int size = sizeof(AssetCookedHeader);
+	for (int i = 0; i < imageCount; i++) {
+		if (images[i].data == NULL) return;
+
+		size += sizeof(AssetCookedImage) + GetPixelDataSize(images[i].width, images[i].height, images[i].format);
+	}
+
+	unsigned char* data = RL_MALLOC(size);
+
+	AssetCookedHeader header = { ASSET_COOKED_MAGIC, ASSET_COOK_VERSION, key, imageCount };
+	memcpy(data, &header, sizeof(header));
+
+	int offset = sizeof(header);
+	for (int i = 0; i < imageCount; i++) {
+		AssetCookedImage info = { images[i].width, images[i].height, images[i].format, images[i].mipmaps };
+		const int pixelSize = GetPixelDataSize(info.Width, info.Height, info.Format);
+
+		memcpy(data + offset, &info, sizeof(info));
+		offset += sizeof(info);
+		memcpy(data + offset, images[i].data, pixelSize);
+		offset += pixelSize;
+	}
+
+	char path[512];
+	asset_cache_path(loader, id, path, sizeof(path));
+	SaveFileData(path, data, size);
+
+	RL_FREE(data);
+}
+
+static void asset_load_image(const AssetLoader* loader, void* asset) {
+	AssetImage* image = (AssetImage*)asset;
+	const int imageCount = image->FlippedCopy ? 2 : 1;
+
+	// Everything that changes the output goes into the id, the source contents go into the key
+	uint64_t id = asset_hash(ASSET_HASH_SEED, image->Path, (int)strlen(image->Path));
+	if (image->Palette != NULL) {
+		id = asset_hash(id, image->Palette, image->ColorCount * sizeof(Color));
+		id = asset_hash(id, &image->Indexed, sizeof(image->Indexed));
+	}
+	id = asset_hash(id, &image->Width, sizeof(image->Width));
+	id = asset_hash(id, &image->Height, sizeof(image->Height));
+	id = asset_hash(id, &image->FlipHorizontal, sizeof(image->FlipHorizontal));
+	id = asset_hash(id, &image->FlippedCopy, sizeof(image->FlippedCopy));
+
+	AssetFile file = asset_file_open(image->Path);
+	const uint64_t key = asset_hash_file(&file, id);
+
+	Image images[2] = { 0 };
+	if (asset_cache_read(loader, id, key, images, imageCount)) {
+		asset_file_close(&file);
+		image->Image = images[0];
+		image->Flipped = images[1];
+		return;
+	}
+
+	image->Image = file.Data != NULL ? LoadImageFromMemory(GetFileExtension(image->Path), file.Data, file.Size) : (Image){ 0 };
+	asset_file_close(&file);
+
+	if (image->Palette != NULL && image->Indexed) {
+		convert_image_to_indices(&image->Image, image->Palette, image->ColorCount);
+	}
+	else if (image->Palette != NULL) {
+		convert_image_colors(&image->Image, image->Palette, image->ColorCount);
+	}
+
+	// ImageResize blends neighbouring texels, that makes no sense for indices
+	assert(!image->Indexed || image->Width == 0);
+	if (image->Width != 0) {
+		ImageResize(&image->Image, image->Width, image->Height);
+	}
+
+	if (image->FlipHorizontal) {
+		ImageFlipHorizontal(&image->Image);
+	}
+
+	if (image->FlippedCopy) {
+		image->Flipped = ImageCopy(image->Image);
+		ImageFlipVertical(&image->Flipped);
+	}
+
+	images[0] = image->Image;
+	images[1] = image->Flipped;
+	asset_cache_write(loader, id, key, images, imageCount);
+}
+
+static void asset_load_job(void* data, int begin, int end) {
+	AssetLoader* loader = (AssetLoader*)data;
+
+	for (int i = begin; i < end; i++) {
+		PROFILE_SLICE_BEGIN("load_asset");
+		PROFILE_SLICE_ARG("asset", i);
+		loader->Funcs[i](loader, loader->Assets[i]);
+		PROFILE_SLICE_END();
+	}
+}
+
+void asset_loader_add(AssetLoader* loader, AssetLoadFunc func, void* asset) {
+	assert(loader->Count < MAX_ASSET_LOADS);
+
+	loader->Funcs[loader->Count] = func;
+	loader->Assets[loader->Count] = asset;
+	loader->Count += 1;
+}
+
+void asset_loader_add_image(AssetLoader* loader, AssetImage* image) {
+	asset_loader_add(loader, asset_load_image, image);
+}
+
+void asset_loader_run(AssetLoader* loader, JobSystem* jobs) {
+	PROFILE_BEGIN(PROFILE_ZONE_ASSET_LOAD);
+	const double start = thread_get_time();
+
+	if (jobs == NULL) {
+		asset_load_job(loader, 0, loader->Count);
+	}
+	else {
+		// One job per asset, image sizes differ too much for anything coarser to balance
+		for (int i = 0; i < loader->Count; i++) {
+			job_system_submit(jobs, asset_load_job, loader, i, i + 1);
+		}
+
+		job_system_wait(jobs);
+	}
+
+	loader->LoadTime = thread_get_time() - start;
+	loader->Count = 0;
+	PROFILE_END(PROFILE_ZONE_ASSET_LOAD);
+}
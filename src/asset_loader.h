@@ -0,0 +1,81 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "job_system.h"
+#include "asset_pack.h"
+
+// Startup asset loading in two stages. Systems queue their CPU side work (PNG decoding, palette
+// conversion, resizing) with asset_loader_add, asset_loader_run spreads it over a job system, and the
+// main thread uploads the results afterwards since it owns the GL context.
+// Load functions must not touch the GPU or audio device. Conversions read the palette lookup table,
+// so call prepare_palette_lut for the palette before running the loader.
+//
+// With a CacheDirectory set, converted images are also cooked: written as raw pixel blobs keyed by the
+// source file's contents plus everything else that affects the result (palette, target size, flips).
+// Later runs load a blob when its key still matches and only convert live when it doesn't.
+//
+// Files are read through asset_file_open, which serves them from the mounted asset pack when there is
+// one and falls back to the loose file otherwise. Cooked blobs are the exception, the loose file wins
+// there since that is where asset_cache_write puts fresh ones.
+
+#define MAX_ASSET_LOADS 32
+#define ASSET_HASH_SEED 0xcbf29ce484222325ull
+#define ASSET_COOK_VERSION 2 // Bump when the conversion code changes, it invalidates every cooked blob
+
+typedef struct AssetLoader AssetLoader;
+typedef void (*AssetLoadFunc)(const AssetLoader* loader, void* asset);
+
+struct AssetLoader {
+	AssetLoadFunc Funcs[MAX_ASSET_LOADS];
+	void* Assets[MAX_ASSET_LOADS];
+	int Count;
+	const char* CacheDirectory; // NULL disables the cooked asset cache
+	double LoadTime; // Seconds spent in the last asset_loader_run
+};
+
+// Common case: a single image, optionally palette converted, resized and flipped
+typedef struct AssetImage {
+	const char* Path;
+	Color* Palette; // Converted to these colours when not NULL
+	uint8_t ColorCount;
+	bool Indexed; // With a Palette: keep palette indices instead of colours, see convert_image_to_indices
+	int Width; // Resized to Width x Height after the conversion when not 0, not for indexed images
+	int Height;
+	bool FlipHorizontal;
+	bool FlippedCopy; // Also produce a vertically flipped copy in Flipped
+
+	Image Image;
+	Image Flipped;
+} AssetImage;
+
+typedef struct AssetFile {
+	const unsigned char* Data; // Followed by a zero byte, NULL when the file doesn't exist
+	int Size;
+	bool FromPack;
+} AssetFile;
+
+void asset_pack_mount(const char* path); // Mount before loading anything, returns quietly without a pack
+void asset_pack_unmount(void);
+
+AssetFile asset_file_open(const char* path);
+void asset_file_close(AssetFile* file);
+Image asset_image_load(const char* path);
+Sound asset_sound_load(const char* path);
+Music asset_music_load(const char* path, AssetFile* file); // Keep file until the music is unloaded, then asset_file_close it
+
+void asset_loader_add(AssetLoader* loader, AssetLoadFunc func, void* asset);
+void asset_loader_add_image(AssetLoader* loader, AssetImage* image);
+void asset_loader_run(AssetLoader* loader, JobSystem* jobs); // jobs may be NULL to load on the calling thread
+
+// Cooked asset cache, for load functions. A cooked asset is identified by its source path and settings,
+// key additionally covers the source file's contents.
+uint64_t asset_hash(uint64_t hash, const void* data, int size);
+uint64_t asset_hash_file(const AssetFile* file, uint64_t hash);
+bool asset_cache_read(const AssetLoader* loader, uint64_t id, uint64_t key, Image* images, int imageCount);
+void asset_cache_write(const AssetLoader* loader, uint64_t id, uint64_t key, const Image* images, int imageCount);
+
+#endif
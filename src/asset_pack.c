@@ -0,0 +1,236 @@
+#include "asset_pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(PLATFORM_WEB)
+	// No mapping on the web, the pack is read into memory once
+#elif defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+	#define ASSET_PACK_MMAP_WIN32
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define ASSET_PACK_MMAP_POSIX
+#endif
+
+struct AssetPack {
+	const unsigned char* Data;
+	size_t Size;
+	const AssetPackEntry* Entries;
+	uint32_t EntryCount;
+#if defined(ASSET_PACK_MMAP_WIN32)
+	HANDLE File;
+	HANDLE Mapping;
+#endif
+};
+
+static bool asset_pack_map(AssetPack* pack, const char* path) {
+#if defined(ASSET_PACK_MMAP_WIN32)
+	pack->File = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (pack->File == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(pack->File, &size);
+	pack->Size = (size_t)size.QuadPart;
+
+	pack->Mapping = pack->Size > 0 ? CreateFileMappingA(pack->File, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+	pack->Data = pack->Mapping != NULL ? MapViewOfFile(pack->Mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+
+	if (pack->Data == NULL) {
+		if (pack->Mapping != NULL) CloseHandle(pack->Mapping);
+		CloseHandle(pack->File);
+		return false;
+	}
+#elif defined(ASSET_PACK_MMAP_POSIX)
+	int file = open(path, O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED) return false;
+
+	pack->Data = data;
+	pack->Size = (size_t)info.st_size;
+#else
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	unsigned char* data = size > 0 ? malloc((size_t)size) : NULL;
+	if (data == NULL || fread(data, 1, (size_t)size, file) != (size_t)size) {
+		free(data);
+		fclose(file);
+		return false;
+	}
+
+	fclose(file);
+
+	pack->Data = data;
+	pack->Size = (size_t)size;
+#endif
+
+	return true;
+}
+
+static void asset_pack_unmap(AssetPack* pack) {
+#if defined(ASSET_PACK_MMAP_WIN32)
+	UnmapViewOfFile(pack->Data);
+	CloseHandle(pack->Mapping);
+	CloseHandle(pack->File);
+#elif defined(ASSET_PACK_MMAP_POSIX)
+	munmap((void*)pack->Data, pack->Size);
+#else
+	free((void*)pack->Data);
+#endif
+}
+
+AssetPack* asset_pack_open(const char* path) {
+	AssetPack* pack = calloc(1, sizeof(AssetPack));
+
+	if (!asset_pack_map(pack, path)) {
+		free(pack);
+		return NULL;
+	}
+
+	AssetPackHeader header = { 0 };
+	if (pack->Size >= sizeof(header)) {
+		memcpy(&header, pack->Data, sizeof(header));
+	}
+
+	bool valid = header.Magic == ASSET_PACK_MAGIC && header.Version == ASSET_PACK_VERSION
+		&& sizeof(header) + (size_t)header.EntryCount * sizeof(AssetPackEntry) <= pack->Size;
+
+	pack->Entries = (const AssetPackEntry*)(pack->Data + sizeof(header));
+	pack->EntryCount = header.EntryCount;
+
+	// Entries must stay inside the file, including the zero byte after them
+	for (uint32_t i = 0; i < pack->EntryCount && valid; i++) {
+		const AssetPackEntry* entry = &pack->Entries[i];
+		valid = entry->Name[ASSET_PACK_MAX_NAME - 1] == '\0' && entry->Offset + entry->PackedSize < pack->Size;
+	}
+
+	if (!valid) {
+		asset_pack_unmap(pack);
+		free(pack);
+		return NULL;
+	}
+
+	return pack;
+}
+
+void asset_pack_close(AssetPack* pack) {
+	if (pack == NULL) return;
+
+	asset_pack_unmap(pack);
+	free(pack);
+}
+
+static int asset_pack_compare(const void* name, const void* entry) {
+	return strcmp((const char*)name, ((const AssetPackEntry*)entry)->Name);
+}
+
+const unsigned char* asset_pack_read(const AssetPack* pack, const char* name, int* size) {
+	const AssetPackEntry* entry = bsearch(name, pack->Entries, pack->EntryCount, sizeof(AssetPackEntry), asset_pack_compare);
+	if (entry == NULL) return NULL;
+
+	const unsigned char* data = pack->Data + entry->Offset;
+
+	if ((entry->Flags & ASSET_PACK_ENTRY_LZ4) == 0) {
+		*size = (int)entry->Size;
+		return data;
+	}
+
+	unsigned char* buffer = malloc((size_t)entry->Size + 1);
+	if (buffer == NULL) return NULL;
+
+	if (lz4_decompress(data, (int)entry->PackedSize, buffer, (int)entry->Size) != (int)entry->Size) {
+		free(buffer);
+		return NULL;
+	}
+
+	buffer[entry->Size] = '\0';
+	*size = (int)entry->Size;
+
+	return buffer;
+}
+
+void asset_pack_release(const AssetPack* pack, const unsigned char* data) {
+	// Only decompressed entries live outside of the pack's memory
+	if (data != NULL && (data < pack->Data || data >= pack->Data + pack->Size)) {
+		free((void*)data);
+	}
+}
+
+// LZ4 block format decoder, returns the decompressed size or -1 on malformed input
+int lz4_decompress(const unsigned char* src, int srcSize, unsigned char* dst, int dstSize) {
+	const unsigned char* ip = src;
+	const unsigned char* const ipEnd = src + srcSize;
+	unsigned char* op = dst;
+	unsigned char* const opEnd = dst + dstSize;
+
+	while (ip < ipEnd) {
+		const unsigned int token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15) {
+			unsigned int extra;
+			do {
+				if (ip >= ipEnd) return -1;
+				extra = *ip++;
+				literals += extra;
+			} while (extra == 255);
+		}
+
+		if (literals > (size_t)(ipEnd - ip) || literals > (size_t)(opEnd - op)) return -1;
+
+		memcpy(op, ip, literals);
+		op += literals;
+		ip += literals;
+
+		// The last sequence only has literals
+		if (ip >= ipEnd) break;
+
+		if (ipEnd - ip < 2) return -1;
+		const size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		if (offset == 0 || offset > (size_t)(op - dst)) return -1;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15) {
+			unsigned int extra;
+			do {
+				if (ip >= ipEnd) return -1;
+				extra = *ip++;
+				matchLength += extra;
+			} while (extra == 255);
+		}
+		matchLength += 4;
+
+		if (matchLength > (size_t)(opEnd - op)) return -1;
+
+		// Matches may overlap the bytes they produce
+		const unsigned char* match = op - offset;
+		for (size_t i = 0; i < matchLength; i++) {
+			op[i] = match[i];
+		}
+		op += matchLength;
+	}
+
+	return (int)(op - dst);
+}
@@ -0,0 +1,48 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Read-only asset pack: every file under resources/ in one file, built by pack_assets.
+// Layout: header, table of contents sorted by name, then the entries at ASSET_PACK_ALIGNMENT.
+// Every entry is followed by a zero byte so text can be parsed in place.
+// The pack is memory mapped, stored entries are served straight from the mapping and LZ4 compressed
+// ones are decompressed into their own buffer.
+// Like threading.h this stays free of raylib.h, mapping files needs windows.h on Windows.
+
+#define ASSET_PACK_MAGIC 0x4b415054 // "TPAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGNMENT 16
+#define ASSET_PACK_MAX_NAME 104
+
+#define ASSET_PACK_ENTRY_LZ4 0x1
+
+typedef struct AssetPackHeader {
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t EntryCount;
+	uint32_t Reserved;
+} AssetPackHeader;
+
+typedef struct AssetPackEntry {
+	char Name[ASSET_PACK_MAX_NAME]; // Path as the game opens it, e.g. "resources/images/portal.png"
+	uint64_t Offset;
+	uint32_t Size;
+	uint32_t PackedSize; // Bytes in the pack, equals Size for stored entries
+	uint32_t Flags;
+	uint32_t Reserved;
+} AssetPackEntry;
+
+typedef struct AssetPack AssetPack;
+
+AssetPack* asset_pack_open(const char* path); // NULL when the file is missing or not a valid pack
+void asset_pack_close(AssetPack* pack);
+
+// Returns the entry's bytes, or NULL when the pack doesn't have it. Release with asset_pack_release.
+const unsigned char* asset_pack_read(const AssetPack* pack, const char* name, int* size);
+void asset_pack_release(const AssetPack* pack, const unsigned char* data);
+
+int lz4_decompress(const unsigned char* src, int srcSize, unsigned char* dst, int dstSize);
+
+#endif
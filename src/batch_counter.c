@@ -0,0 +1,85 @@
+#include "batch_counter.h"
+
+#if defined(SUPPORT_RENDER_STATS)
+
+#include <string.h>
+
+void batch_counter_init(BatchCounter* counter) {
+    memset(counter, 0, sizeof(BatchCounter));
+    counter->Batch = rlLoadRenderBatch(2, BATCH_COUNTER_ELEMENTS);
+}
+
+void batch_counter_exit(BatchCounter* counter) {
+    rlUnloadRenderBatch(counter->Batch);
+    memset(counter, 0, sizeof(BatchCounter));
+}
+
+static void count_draw(BatchCounter* counter, const rlDrawCall* draw) {
+    if (draw->vertexCount == 0) return;
+
+    counter->DrawCalls += 1;
+
+    if (draw->textureId != counter->LastTexture) {
+        counter->TextureBinds += 1;
+        counter->LastTexture = draw->textureId;
+    }
+}
+
+void batch_counter_begin(BatchCounter* counter) {
+    rlSetRenderBatchActive(&counter->Batch);
+
+    counter->DrawCalls = 0;
+    counter->TextureBinds = 0;
+    counter->BatchFlushes = 0;
+    counter->CurrentBuffer = counter->Batch.currentBuffer;
+    counter->DrawCounter = 0;
+    counter->Vertices = 0;
+    counter->OpenTexture = 0;
+    counter->OpenVertices = 0;
+    counter->LastTexture = 0;
+
+    batch_counter_sample(counter);
+}
+
+void batch_counter_sample(BatchCounter* counter) {
+    const rlRenderBatch* batch = &counter->Batch;
+
+    int vertices = 0;
+    for (int i = 0; i < batch->drawCounter; i++) {
+        vertices += batch->draws[i].vertexCount;
+    }
+
+    int firstNew = counter->DrawCounter - 1;
+
+    if (batch->currentBuffer != counter->CurrentBuffer) {
+        // The draw that was still open went out with the flush
+        const rlDrawCall open = { .vertexCount = counter->OpenVertices, .textureId = counter->OpenTexture };
+        count_draw(counter, &open);
+        if (counter->Vertices > 0) counter->BatchFlushes += 1;
+
+        firstNew = 0;
+    }
+
+    // Draws closed since the last sample
+    for (int i = firstNew < 0 ? 0 : firstNew; i < batch->drawCounter - 1; i++) {
+        count_draw(counter, &batch->draws[i]);
+    }
+
+    counter->CurrentBuffer = batch->currentBuffer;
+    counter->DrawCounter = batch->drawCounter;
+    counter->Vertices = vertices;
+    counter->OpenTexture = batch->draws[batch->drawCounter - 1].textureId;
+    counter->OpenVertices = batch->draws[batch->drawCounter - 1].vertexCount;
+}
+
+void batch_counter_end(BatchCounter* counter) {
+    batch_counter_sample(counter);
+
+    const rlDrawCall open = { .vertexCount = counter->OpenVertices, .textureId = counter->OpenTexture };
+    count_draw(counter, &open);
+    if (counter->Vertices > 0) counter->BatchFlushes += 1;
+
+    rlSetRenderBatchActive(NULL);
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BATCH_COUNTER_H
+#define BATCH_COUNTER_H
+
+// Measured draw calls for the benchmarks. Between batch_counter_begin and batch_counter_end everything is
+// drawn into the counter's own rlgl batch, batch_counter_sample reads it back after every state change
+// and every draw: draws[] and drawCounter tell which draw calls rlgl made and with which texture.
+// The batch has two buffers, rlDrawRenderBatch moves on to the other one with every flush, so a flush
+// since the last sample always shows, whatever caused it.
+// Only built with SUPPORT_RENDER_STATS, see bench_render and bench_particles.
+#if defined(SUPPORT_RENDER_STATS)
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rlgl.h"
+
+// rlgl.h only knows the desktop default when included here, match what raylib picks for GLES2
+#if defined(PLATFORM_WEB) || defined(PLATFORM_ANDROID) || defined(PLATFORM_DRM)
+    #define BATCH_COUNTER_ELEMENTS 2048
+#else
+    #define BATCH_COUNTER_ELEMENTS RL_DEFAULT_BATCH_BUFFER_ELEMENTS
+#endif
+
+typedef struct BatchCounter {
+    rlRenderBatch Batch; // Two buffers of BATCH_COUNTER_ELEMENTS
+
+    uint32_t DrawCalls;
+    uint32_t TextureBinds; // Draw calls with another texture than the one before
+    uint32_t BatchFlushes;
+
+    // Where Batch stood at the last sample. Draws before the open one are complete and already counted.
+    int CurrentBuffer;
+    int DrawCounter;
+    int Vertices;
+    unsigned int OpenTexture;
+    int OpenVertices;
+    unsigned int LastTexture;
+} BatchCounter;
+
+// Both need the GL context
+void batch_counter_init(BatchCounter* counter);
+void batch_counter_exit(BatchCounter* counter);
+
+// Resets the counts and makes Batch the active rlgl batch
+void batch_counter_begin(BatchCounter* counter);
+// Counts the draws closed or flushed since the last sample. Sample often enough that no more than one
+// flush happens in between, and that no draw is opened and flushed again without a sample.
+void batch_counter_sample(BatchCounter* counter);
+// Counts what is still in the batch, sends it off and gives rlgl back its default batch
+void batch_counter_end(BatchCounter* counter);
+
+#endif
+
+#endif
@@ -0,0 +1,280 @@
+// Headless game_tick benchmark
+// Runs every level in resources/levels plus a few generated stress levels for a fixed number of ticks
+// with scripted input, no window or audio device. Reports ns/tick, ticks/s and the spread per level.
+// Build with `make bench_game PLATFORM=PLATFORM_DESKTOP`, run from src/ so the levels are found.
+// `bench_game --ticks 50000 --json results.json` also writes the results for comparing builds.
+
+#include "game.h"
+#include "level_parser.h"
+#include "threading.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_LEVEL_DIRECTORY "resources/levels"
+#define BENCH_MAX_LEVEL_TILES (11 * 500)      // Same assumption as the game makes
+#define BENCH_SCREEN_WIDTH 800
+#define BENCH_SCREEN_HEIGHT 450
+#define BENCH_TICK_DT (1.3f / 60.0f)          // The game speeds up dt by 1.3 as well
+#define BENCH_DEFAULT_TICKS 20000
+#define BENCH_WARMUP_TICKS 600
+#define BENCH_MAX_LEVELS 16
+
+typedef struct BenchResult {
+    char Name[64];
+    uint32_t LevelWidth;
+    int EnemyCount;
+    int TickCount;
+    int Restarts;
+    int LevelsCompleted;
+
+    double MeanNs;
+    double StdDevNs;
+    double MinNs;
+    double MedianNs;
+    double P99Ns;
+    double MaxNs;
+} BenchResult;
+
+// Stress level: a long run of the usual obstacles with every enemy slot filled
+typedef struct StressLevel {
+    const char* Name;
+    uint32_t Width;
+    int ObstacleSpacing;
+    int EnemyCount;
+} StressLevel;
+
+static const StressLevel StressLevels[] = {
+    { "stress_long", 4000, 24, MAX_ENEMIES },
+    { "stress_dense", 320, 8, MAX_ENEMIES },
+};
+
+// Same layout as the level files: row 5 is the floor both characters run on, row 4 is the top
+// character's side and row 6 the bottom one's.
+static void generate_stress_level(LevelData* level, const StressLevel* stress) {
+    level->LevelWidth = stress->Width;
+    level->LevelHeight = 11;
+    level->Tiles = calloc(level->LevelWidth * level->LevelHeight, sizeof(uint16_t));
+
+    const uint32_t width = level->LevelWidth;
+
+    for (uint32_t y = 0; y < level->LevelHeight; y++) {
+        level->Tiles[y * width] = TILE_PLATFORM;
+    }
+
+    for (uint32_t x = 0; x < width; x++) {
+        level->Tiles[x + 5 * width] = TILE_FLOOR;
+    }
+
+    level->Tiles[3 + 4 * width] = TILE_SPAWN_1;
+    level->Tiles[3 + 6 * width] = TILE_SPAWN_2;
+
+    for (uint32_t x = 20; x + 10 < width; x += stress->ObstacleSpacing) {
+        level->Tiles[x + 4 * width] = TILE_PLATFORM;
+        level->Tiles[x + 1 + 4 * width] = TILE_PLATFORM;
+        level->Tiles[x + stress->ObstacleSpacing / 2 + 6 * width] = TILE_PLATFORM;
+    }
+
+    // Enemies sit between the obstacles, alternating sides
+    const uint32_t enemySpacing = (width - 40) / stress->EnemyCount;
+    for (int i = 0; i < stress->EnemyCount; i++) {
+        const uint32_t x = 30 + i * enemySpacing;
+        const uint32_t y = (i % 2 == 0) ? 4 : 6;
+
+        if (level->Tiles[x + y * width] == TILE_VOID) {
+            level->Tiles[x + y * width] = TILE_ENEMY;
+        }
+    }
+
+    level->Tiles[(width - 4) + 4 * width] = TILE_PORTAL_1;
+    level->Tiles[(width - 4) + 6 * width] = TILE_PORTAL_2;
+}
+
+// Jump in a fixed rhythm, fire constantly and pass the gun around now and then
+static GameInput scripted_input(int tick) {
+    GameInput input = { 0 };
+
+    const int jumpPhase = tick % 45;
+    input.JumpPressed = jumpPhase == 0;
+    input.JumpDown = jumpPhase < 12;
+    input.FirePressed = tick % 15 == 0;
+    input.SwapGunPressed = tick % 180 == 90;
+
+    return input;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    const double da = *(const double*)a;
+    const double db = *(const double*)b;
+
+    return (da > db) - (da < db);
+}
+
+// Mirrors what app_loop does around the tick, minus the sim thread, drawing and audio
+static BenchResult run_level(const char* name, const LevelData* level, int tickCount, double* tickTimes) {
+    BenchResult result = { 0 };
+    snprintf(result.Name, sizeof(result.Name), "%s", name);
+    result.LevelWidth = level->LevelWidth;
+    result.TickCount = tickCount;
+
+    GameData* gameData = calloc(1, sizeof(GameData));
+    gameData->TileSize = BENCH_SCREEN_HEIGHT / (float)level->LevelHeight;
+    gameData->CharFrameCount = 6;
+    gameData->EnemyFrameCount = 3;
+    gameData->PortalFrameCount = 8;
+    effects_create(&gameData->Effects);
+
+    SetRandomSeed(1234);
+    game_restart(gameData, level);
+    result.EnemyCount = gameData->EnemyCount;
+
+    for (int tick = -BENCH_WARMUP_TICKS; tick < tickCount; tick++) {
+        const GameInput input = scripted_input(tick + BENCH_WARMUP_TICKS);
+
+        const double start = thread_get_time();
+        game_tick(gameData, level, &input, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, BENCH_TICK_DT);
+        const double end = thread_get_time();
+
+        if (tick >= 0) {
+            tickTimes[tick] = (end - start) * 1e9;
+        }
+
+        gameData->SoundEvents.Count = 0;
+
+        if (gameData->RestartLevel || gameData->NextLevel) {
+            if (tick >= 0) {
+                result.Restarts += gameData->RestartLevel;
+                result.LevelsCompleted += gameData->NextLevel;
+            }
+
+            gameData->RestartLevel = false;
+            game_restart(gameData, level);
+        }
+    }
+
+    effects_exit(&gameData->Effects);
+    free(gameData);
+
+    double sum = 0.0;
+    for (int i = 0; i < tickCount; i++) {
+        sum += tickTimes[i];
+    }
+    result.MeanNs = sum / tickCount;
+
+    double squares = 0.0;
+    for (int i = 0; i < tickCount; i++) {
+        squares += (tickTimes[i] - result.MeanNs) * (tickTimes[i] - result.MeanNs);
+    }
+    result.StdDevNs = sqrt(squares / tickCount);
+
+    qsort(tickTimes, tickCount, sizeof(double), compare_doubles);
+    result.MinNs = tickTimes[0];
+    result.MedianNs = tickTimes[tickCount / 2];
+    result.P99Ns = tickTimes[(tickCount * 99 + 99) / 100 - 1];
+    result.MaxNs = tickTimes[tickCount - 1];
+
+    return result;
+}
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static bool write_json(const char* fileName, const BenchResult* results, int resultCount) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"benchmark\": \"game_tick\",\n  \"dt\": %f,\n  \"warmup_ticks\": %d,\n  \"levels\": [\n", BENCH_TICK_DT, BENCH_WARMUP_TICKS);
+
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult* r = &results[i];
+
+        fprintf(file, "    { \"name\": \"%s\", \"width\": %u, \"enemies\": %d, \"ticks\": %d, \"restarts\": %d, \"completed\": %d, ",
+            r->Name, r->LevelWidth, r->EnemyCount, r->TickCount, r->Restarts, r->LevelsCompleted);
+        fprintf(file, "\"ns_per_tick\": %.1f, \"ticks_per_sec\": %.0f, \"stddev_ns\": %.1f, \"variance_ns2\": %.1f, \"min_ns\": %.1f, \"median_ns\": %.1f, \"p99_ns\": %.1f, \"max_ns\": %.1f }%s\n",
+            r->MeanNs, 1e9 / r->MeanNs, r->StdDevNs, r->StdDevNs * r->StdDevNs, r->MinNs, r->MedianNs, r->P99Ns, r->MaxNs, i + 1 < resultCount ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int tickCount = BENCH_DEFAULT_TICKS;
+    const char* jsonFileName = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            tickCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonFileName = argv[++i];
+        }
+        else {
+            printf("usage: %s [--ticks N] [--json file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (tickCount < 1) tickCount = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    double* tickTimes = malloc(tickCount * sizeof(double));
+    BenchResult results[BENCH_MAX_LEVELS + sizeof(StressLevels) / sizeof(StressLevels[0])];
+    int resultCount = 0;
+
+    printf("%-16s %6s %7s %12s %14s %12s %12s %12s %8s\n", "level", "width", "enemies", "ns/tick", "ticks/s", "stddev ns", "p99 ns", "max ns", "restarts");
+
+    FilePathList levelFiles = LoadDirectoryFilesEx(BENCH_LEVEL_DIRECTORY, ".txt", false);
+    qsort(levelFiles.paths, levelFiles.count, sizeof(char*), compare_paths);
+
+    LevelData level = { 0 };
+    level.Tiles = calloc(BENCH_MAX_LEVEL_TILES, sizeof(uint16_t));
+
+    for (unsigned int i = 0; i < levelFiles.count && i < BENCH_MAX_LEVELS; i++) {
+        memset(level.Tiles, 0, BENCH_MAX_LEVEL_TILES * sizeof(uint16_t));
+        parse_level(levelFiles.paths[i], &level);
+
+        results[resultCount] = run_level(GetFileNameWithoutExt(levelFiles.paths[i]), &level, tickCount, tickTimes);
+        resultCount += 1;
+    }
+
+    free(level.Tiles);
+    UnloadDirectoryFiles(levelFiles);
+
+    for (int i = 0; i < (int)(sizeof(StressLevels) / sizeof(StressLevels[0])); i++) {
+        LevelData stressLevel = { 0 };
+        generate_stress_level(&stressLevel, &StressLevels[i]);
+
+        results[resultCount] = run_level(StressLevels[i].Name, &stressLevel, tickCount, tickTimes);
+        resultCount += 1;
+
+        free(stressLevel.Tiles);
+    }
+
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult* r = &results[i];
+        printf("%-16s %6u %7d %12.1f %14.0f %12.1f %12.1f %12.1f %8d\n",
+            r->Name, r->LevelWidth, r->EnemyCount, r->MeanNs, 1e9 / r->MeanNs, r->StdDevNs, r->P99Ns, r->MaxNs, r->Restarts);
+    }
+
+    free(tickTimes);
+
+    if (jsonFileName != NULL) {
+        if (!write_json(jsonFileName, results, resultCount)) {
+            printf("Failed to write %s\n", jsonFileName);
+            return 1;
+        }
+
+        printf("\nWrote %s\n", jsonFileName);
+    }
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+// Particle throughput benchmark
+// Compares Emitter_Update and Emitter_Burst against their original versions at 10k, 100k and 1M particles,
+// then measures how ParticleSystem_Update scales over 1 to 32 job system threads.
+// Finally it draws a small scene into a hidden window, emitter by emitter and grouped by ParticleSystem_Draw.
+// Both passes go through a BatchCounter, the grouped pass has to measure one draw call per (blend mode, texture)
+// pair and agree with ParticleSystem_GetDrawCallCount. Needs a GL context, xvfb with llvmpipe works.
+// Build with `make bench_particles PLATFORM=PLATFORM_DESKTOP`
+
+#include "particles.h"
+#include "batch_counter.h"
+#include "threading.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#if !defined(SUPPORT_RENDER_STATS)
+    #error "bench_particles measures draw calls with a BatchCounter, build it with -DSUPPORT_RENDER_STATS"
+#endif
+
+#define BENCH_FRAME_DT (1.0f / 60.0f)
+#define BENCH_PARTICLE_UPDATES 200000000.0    // Particle updates per run, frame count is derived from this
+
+// Scaling scene: many effect sized emitters plus a few huge ones that get split into range jobs
+#define BENCH_SCENE_SMALL_EMITTERS 64
+#define BENCH_SCENE_SMALL_PARTICLES 20000
+#define BENCH_SCENE_LARGE_EMITTERS 2
+#define BENCH_SCENE_LARGE_PARTICLES 1000000
+#define BENCH_SCENE_FRAMES 60
+
+// Draw scene: emitters alternate between two blend modes and two textures, so drawing them one by one
+// never shares state between neighbours, while grouping needs one draw call per (blend mode, texture) pair
+#define BENCH_DRAW_EMITTERS 24
+#define BENCH_DRAW_PARTICLES 64
+#define BENCH_DRAW_GROUPS 4
+
+// The Emitter_Update from before the fused pass, kept here as the baseline.
+// Its kill loop skips the particle that was just swapped in, so it can keep dead particles alive for a frame.
+static void legacy_emitter_update(Emitter* e, float dt) {
+    for (int i = 0; i < e->activeParticles; i++) {
+        e->particleAges[i] += dt;
+    }
+
+    for (int i = 0; i < e->activeParticles; i++) {
+        if (e->particleAges[i] > e->particleTTL[i]) {
+            e->particlePositions[i] = e->particlePositions[e->activeParticles - 1];
+            e->particleVelocities[i] = e->particleVelocities[e->activeParticles - 1];
+            e->particlesAccellerationExt[i] = e->particlesAccellerationExt[e->activeParticles - 1];
+            e->particleSizes[i] = e->particleSizes[e->activeParticles - 1];
+            e->particleAges[i] = e->particleAges[e->activeParticles - 1];
+            e->particleTTL[i] = e->particleTTL[e->activeParticles - 1];
+            e->particleHaltTimes[i] = e->particleHaltTimes[e->activeParticles - 1];
+
+            e->activeParticles--;
+        }
+    }
+
+    for (int i = 0; i < e->activeParticles; i++) {
+        if (e->particleAges[i] > e->particleHaltTimes[i]) {
+            e->particleVelocities[i] = (Vector2){ 0.0f, 0.0f };
+            e->particlesAccellerationExt[i] = (Vector2){ 0.0f, 0.0f };
+        }
+    }
+
+    for (int i = 0; i < e->activeParticles; i++) {
+        e->particleVelocities[i] = Vector2Add(e->particleVelocities[i], Vector2Multiply(e->particlesAccellerationExt[i], (Vector2) { dt, dt }));
+    }
+
+    for (int i = 0; i < e->activeParticles; i++) {
+        e->particlePositions[i] = Vector2Add(e->particlePositions[i], Vector2Multiply(e->particleVelocities[i], (Vector2) { dt, dt }));
+    }
+}
+
+// The Emitter_Burst from before the per emitter RNG, six GetRandomFloat calls per particle.
+static void legacy_emitter_burst(Emitter* e) {
+    int amount = GetRandomValue(e->config.burst.min, e->config.burst.max);
+
+    for (int i = e->activeParticles; i < e->activeParticles + amount; i++) {
+        float randa = GetRandomFloat(e->config.directionAngle.min, e->config.directionAngle.max);
+        Vector2 res = Vector2Rotate(e->config.direction, randa * DEG2RAD);
+        float randv = GetRandomFloat(e->config.velocity.min, e->config.velocity.max);
+        randa = GetRandomFloat(e->config.velocityAngle.min, e->config.velocityAngle.max);
+        float rando = GetRandomFloat(e->config.offset.min, e->config.offset.max);
+
+        e->particlePositions[i] = (Vector2){ e->config.origin.x + rando, e->config.origin.y + rando };
+        e->particleVelocities[i] = Vector2Rotate((Vector2){ res.x * randv, res.y * randv }, randa * DEG2RAD);
+        e->particlesAccellerationExt[i] = (Vector2){ e->config.externalAcceleration.x, e->config.externalAcceleration.y };
+        e->particleSizes[i] = GetRandomFloat(e->config.size.min, e->config.size.max);
+        e->particleAges[i] = 0.0f;
+        e->particleTTL[i] = GetRandomFloat(e->config.age.min, e->config.age.max);
+        e->particleHaltTimes[i] = GetRandomFloat(e->config.haltTime.min, e->config.haltTime.max);
+    }
+
+    e->activeParticles += amount;
+}
+
+// Fills an emitter to capacity. Particles outlive the run, about half of them halt along the way,
+// or all of them right away for decal style particles.
+static Emitter* create_emitter(int particleCount, int frameCount, bool decals) {
+    const float runTime = frameCount * BENCH_FRAME_DT;
+
+    EmitterConfig config = {
+        .direction = (Vector2){ 0.0f, -1.0f },
+        .velocity = (FloatRange){ 10.0f, 100.0f },
+        .directionAngle = (FloatRange){ -180.0f, 180.0f },
+        .velocityAngle = (FloatRange){ 0.0f, 0.0f },
+        .offset = (FloatRange){ -5.0f, 5.0f },
+        .size = (FloatRange){ 1.0f, 3.0f },
+        .capacity = particleCount,
+        .externalAcceleration = (Vector2){ 0.0f, 98.0f },
+        .Color = WHITE,
+        .age = (FloatRange){ runTime + 1.0f, runTime + 2.0f },
+        .haltTime = decals ? (FloatRange){ 0.0f, 0.0f } : (FloatRange){ 0.0f, runTime * 2.0f },
+        .blendMode = BLEND_ALPHA,
+    };
+
+    Emitter* e = Emitter_New(config);
+    if (e == NULL) {
+        return NULL;
+    }
+
+    ParticleRng_Seed(&e->rng, 1234);
+    Emitter_Tweak_Burst(e, particleCount, particleCount);
+    Emitter_Burst(e);
+
+    return e;
+}
+
+static Emitter* create_filled_emitter(int particleCount, int frameCount) {
+    return create_emitter(particleCount, frameCount, false);
+}
+
+static double run_update(void (*update)(Emitter*, float), int particleCount, int frameCount, bool decals) {
+    Emitter* e = create_emitter(particleCount, frameCount, decals);
+    if (e == NULL) {
+        return 0.0;
+    }
+
+    const clock_t start = clock();
+    for (int frame = 0; frame < frameCount; frame++) {
+        update(e, BENCH_FRAME_DT);
+    }
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    Emitter_Free(e);
+
+    return seconds > 0.0 ? (double)particleCount * frameCount / seconds : 0.0;
+}
+
+static double run_burst(void (*burst)(Emitter*), int particleCount, int burstCount) {
+    Emitter* e = create_filled_emitter(particleCount, 1);
+    if (e == NULL) {
+        return 0.0;
+    }
+
+    const clock_t start = clock();
+    for (int i = 0; i < burstCount; i++) {
+        e->activeParticles = 0;
+        e->movingParticles = 0;
+        burst(e);
+    }
+    const double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    Emitter_Free(e);
+
+    return seconds > 0.0 ? (double)particleCount * burstCount / seconds : 0.0;
+}
+
+// Returns the average ParticleSystem_Update time in seconds. jobs may be NULL for the serial path.
+static double run_scene(JobSystem* jobs) {
+    ParticleSystem* ps = ParticleSystem_New();
+    ParticleSystem_SetJobSystem(ps, jobs);
+
+    for (int i = 0; i < BENCH_SCENE_SMALL_EMITTERS; i++) {
+        ParticleSystem_Register(ps, create_filled_emitter(BENCH_SCENE_SMALL_PARTICLES, BENCH_SCENE_FRAMES));
+    }
+    for (int i = 0; i < BENCH_SCENE_LARGE_EMITTERS; i++) {
+        ParticleSystem_Register(ps, create_filled_emitter(BENCH_SCENE_LARGE_PARTICLES, BENCH_SCENE_FRAMES));
+    }
+
+    const double start = thread_get_time();
+    for (int frame = 0; frame < BENCH_SCENE_FRAMES; frame++) {
+        ParticleSystem_Update(ps, BENCH_FRAME_DT);
+    }
+    const double seconds = (thread_get_time() - start) / BENCH_SCENE_FRAMES;
+
+    ParticleSystem_CleanAndFree(ps);
+
+    return seconds;
+}
+
+static void observe_draw(void* user) {
+    batch_counter_sample((BatchCounter*)user);
+}
+
+// Returns false when the grouped pass doesn't measure one draw call per (blend mode, texture) pair
+static bool run_draw_scene(void) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(320, 180, "bench_particles");
+
+    Image image = GenImageColor(4, 4, WHITE);
+    const Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    ParticleSystem* ps = ParticleSystem_New();
+
+    for (int i = 0; i < BENCH_DRAW_EMITTERS; i++) {
+        EmitterConfig config = {
+            .direction = (Vector2){ 0.0f, -1.0f },
+            .velocity = (FloatRange){ 10.0f, 40.0f },
+            .directionAngle = (FloatRange){ -180.0f, 180.0f },
+            .offset = (FloatRange){ -5.0f, 5.0f },
+            .size = (FloatRange){ 1.0f, 3.0f },
+            .burst = (IntRange){ BENCH_DRAW_PARTICLES, BENCH_DRAW_PARTICLES },
+            .capacity = BENCH_DRAW_PARTICLES,
+            .origin = (Vector2){ 20.0f + 12.0f * i, 90.0f },
+            .Color = WHITE,
+            .age = (FloatRange){ 1.0f, 2.0f },
+            .haltTime = (FloatRange){ 1.0f, 2.0f },
+            .blendMode = (i % 2 == 0) ? BLEND_ALPHA : BLEND_ADDITIVE,
+        };
+        if ((i / 2) % 2 == 0) config.texture = texture;
+
+        Emitter* e = Emitter_New(config);
+        Emitter_Burst(e);
+        ParticleSystem_Register(ps, e);
+    }
+
+    RenderTexture2D target = LoadRenderTexture(320, 180);
+    BatchCounter counter;
+    batch_counter_init(&counter);
+    Particles_SetDrawObserver(observe_draw, &counter);
+
+    BeginTextureMode(target);
+    batch_counter_begin(&counter);
+    int ungroupedReported = 0;
+    for (int i = 0; i < BENCH_DRAW_EMITTERS; i++) {
+        ungroupedReported += Emitter_Draw(ps->emitters[i]);
+    }
+    batch_counter_end(&counter);
+    EndTextureMode();
+    const BatchCounter ungrouped = counter;
+
+    BeginTextureMode(target);
+    batch_counter_begin(&counter);
+    ParticleSystem_Draw(ps);
+    batch_counter_end(&counter);
+    EndTextureMode();
+    const BatchCounter grouped = counter;
+    const int groupedReported = ParticleSystem_GetDrawCallCount(ps);
+
+    Particles_SetDrawObserver(NULL, NULL);
+    batch_counter_exit(&counter);
+
+    printf("\nDraw calls, %d emitters, 2 blend modes x 2 textures\n", BENCH_DRAW_EMITTERS);
+    printf("%10s %10s %10s %10s\n", "", "draws", "flushes", "reported");
+    printf("%10s %10u %10u %10d\n", "ungrouped", ungrouped.DrawCalls, ungrouped.BatchFlushes, ungroupedReported);
+    printf("%10s %10u %10u %10d\n", "grouped", grouped.DrawCalls, grouped.BatchFlushes, groupedReported);
+
+    ParticleSystem_CleanAndFree(ps);
+    UnloadRenderTexture(target);
+    UnloadTexture(texture);
+    CloseWindow();
+
+    if (grouped.DrawCalls != BENCH_DRAW_GROUPS || (int)grouped.DrawCalls != groupedReported) {
+        printf("FAILED: expected %d measured and reported grouped draw calls\n", BENCH_DRAW_GROUPS);
+        return false;
+    }
+
+    return true;
+}
+
+int main(void) {
+    const int particleCounts[] = { 10000, 100000, 1000000 };
+
+    printf("%10s %18s %18s %8s\n", "update", "legacy (p/s)", "fused (p/s)", "speedup");
+
+    for (int i = 0; i < (int)(sizeof(particleCounts) / sizeof(particleCounts[0])); i++) {
+        const int count = particleCounts[i];
+        int frameCount = (int)(BENCH_PARTICLE_UPDATES / count);
+        if (frameCount < 20) frameCount = 20;
+
+        const double legacy = run_update(legacy_emitter_update, count, frameCount, false);
+        const double fused = run_update(Emitter_Update, count, frameCount, false);
+
+        printf("%10d %18.0f %18.0f %7.2fx\n", count, legacy, fused, legacy > 0.0 ? fused / legacy : 0.0);
+    }
+
+    // Halted particles sit in their own range and only age
+    printf("\n%10s %18s %18s %8s\n", "decals", "legacy (p/s)", "fused (p/s)", "speedup");
+
+    for (int i = 0; i < (int)(sizeof(particleCounts) / sizeof(particleCounts[0])); i++) {
+        const int count = particleCounts[i];
+        int frameCount = (int)(BENCH_PARTICLE_UPDATES / count);
+        if (frameCount < 20) frameCount = 20;
+
+        const double legacy = run_update(legacy_emitter_update, count, frameCount, true);
+        const double fused = run_update(Emitter_Update, count, frameCount, true);
+
+        printf("%10d %18.0f %18.0f %7.2fx\n", count, legacy, fused, legacy > 0.0 ? fused / legacy : 0.0);
+    }
+
+    printf("\n%10s %18s %18s %8s\n", "burst", "legacy (p/s)", "batched (p/s)", "speedup");
+
+    for (int i = 0; i < (int)(sizeof(particleCounts) / sizeof(particleCounts[0])); i++) {
+        const int count = particleCounts[i];
+        int burstCount = (int)(BENCH_PARTICLE_UPDATES / 10 / count);
+        if (burstCount < 5) burstCount = 5;
+
+        const double legacy = run_burst(legacy_emitter_burst, count, burstCount);
+        const double batched = run_burst(Emitter_Burst, count, burstCount);
+
+        printf("%10d %18.0f %18.0f %7.2fx\n", count, legacy, batched, legacy > 0.0 ? batched / legacy : 0.0);
+    }
+
+    const int sceneParticles = BENCH_SCENE_SMALL_EMITTERS * BENCH_SCENE_SMALL_PARTICLES + BENCH_SCENE_LARGE_EMITTERS * BENCH_SCENE_LARGE_PARTICLES;
+    printf("\nParticleSystem_Update, %d particles in %d emitters, %d cpus\n", sceneParticles,
+        BENCH_SCENE_SMALL_EMITTERS + BENCH_SCENE_LARGE_EMITTERS, thread_get_cpu_count());
+    printf("%10s %12s %18s %8s\n", "threads", "ms/frame", "particles/s", "speedup");
+
+    const double serial = run_scene(NULL);
+    printf("%10s %12.3f %18.0f %7.2fx\n", "serial", serial * 1000.0, sceneParticles / serial, 1.0);
+
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        JobSystem* jobs = job_system_create(threads);
+        const double frame = run_scene(jobs);
+        job_system_destroy(jobs);
+
+        printf("%10d %12.3f %18.0f %7.2fx\n", threads, frame * 1000.0, sceneParticles / frame, serial / frame);
+    }
+
+    if (!run_draw_scene()) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+// Offscreen render benchmark
+// Sweeps the camera over every level in resources/levels and renders the parallax bands, game_draw and
+// a UI panel into a render texture, the same way app_loop records and submits a gameplay frame.
+// Reports frame time plus the RenderStats of each submit: draw calls, batch flushes and texture binds as
+// measured on the queue's own rlgl batch, and the rectangles, sprites, text and quads handed to raylib.
+// The Makefile builds it with SUPPORT_RENDER_STATS, which also adds that bookkeeping to the frame times.
+// Build with `make bench_render PLATFORM=PLATFORM_DESKTOP` and run from src/. No GPU needed:
+//   xvfb-run -a env LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe ./bench_render --json results.json
+
+#include "game.h"
+#include "level_parser.h"
+#include "parallax.h"
+#include "UISystem.h"
+#include "render_queue.h"
+#include "asset_loader.h"
+#include "image_color_parser.h"
+#include "threading.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(SUPPORT_RENDER_STATS)
+    #error "bench_render reads RenderQueue.Stats, build it with -DSUPPORT_RENDER_STATS"
+#endif
+
+#define BENCH_LEVEL_DIRECTORY "resources/levels"
+#define BENCH_MAX_LEVEL_TILES (11 * 500)      // Same assumption as the game makes
+#define BENCH_SCREEN_WIDTH 800
+#define BENCH_SCREEN_HEIGHT 450
+#define BENCH_FRAME_DT (1.0f / 60.0f)
+#define BENCH_DEFAULT_FRAMES 600
+#define BENCH_WARMUP_FRAMES 30
+#define BENCH_BURST_INTERVAL 20               // Frames between particle bursts, so the particle layer isn't empty
+#define BENCH_MAX_LEVELS 16
+
+typedef struct BenchResult {
+    char Name[64];
+    int FrameCount;
+
+    double MeanMs;
+    double P99Ms;
+    double MaxMs;
+    double RecordMs;                          // Filling the render queue, CPU only
+
+    // Averages per frame
+    double Commands;
+    double DrawCalls;
+    double BatchFlushes;
+    double TextureBinds;
+    double Rectangles;
+    double Circles;
+    double Sprites;
+    double Texts;
+    double Quads;
+} BenchResult;
+
+typedef struct BenchScene {
+    RenderQueue Queue;
+    RenderTexture2D Target;
+    Color Palette[8];
+    ParallaxBand Woods;
+    ParallaxBand Cave;
+    GameData* Game;
+    UIData* UI;
+} BenchScene;
+
+static int compare_doubles(const void* a, const void* b) {
+    const double da = *(const double*)a;
+    const double db = *(const double*)b;
+
+    return (da > db) - (da < db);
+}
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Same steps as main: palette, queued image loads, then one batch of uploads
+static void load_scene(BenchScene* scene, const LevelData* firstLevel) {
+    Image paletteImage = asset_image_load("resources/palettes/custodian.png");
+    Color* colors = LoadImageColors(paletteImage);
+    memcpy(scene->Palette, colors, 8 * sizeof(Color));
+    UnloadImageColors(colors);
+    UnloadImage(paletteImage);
+
+    prepare_palette_lut(scene->Palette, 8);
+    render_queue_init(&scene->Queue, scene->Palette, 8);
+
+    AssetLoader loader = { 0 };
+    loader.CacheDirectory = "resources/cooked";
+
+    parallax_create_game_bands(&scene->Woods, &scene->Cave, &loader, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, scene->Palette, 8);
+
+    scene->Game = calloc(1, sizeof(GameData));
+    game_create(scene->Game, firstLevel, scene->Palette, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, &loader);
+
+    JobSystem* jobs = job_system_create(thread_get_cpu_count());
+    asset_loader_run(&loader, jobs);
+    job_system_destroy(jobs);
+
+    parallax_band_bake(&scene->Woods);
+    parallax_band_bake(&scene->Cave);
+    game_upload_textures(scene->Game, scene->Palette);
+
+    // A panel like the in-game intro, text included
+    scene->UI = calloc(1, sizeof(UIData));
+    ui_add_rectangle(scene->UI, BENCH_SCREEN_WIDTH / 2 - 155, BENCH_SCREEN_HEIGHT / 2 - 105, 490, 210, 1);
+    ui_add_rectangle_with_text(scene->UI, BENCH_SCREEN_WIDTH / 2 - 150, BENCH_SCREEN_HEIGHT / 2 - 100, 480, 200, 0, "You might be wondering:\n\nHow did I get here? Who am I? ...Who are we?", UIStyleTextInGameInstructions);
+    ui_add_button(scene->UI, BENCH_SCREEN_WIDTH / 2 - 90, BENCH_SCREEN_HEIGHT / 2 + 120, 180, 40, "Yes", UIStyleButtonMainMenu, NULL, NULL, true);
+
+    scene->Target = LoadRenderTexture(BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+}
+
+static void unload_scene(BenchScene* scene) {
+    UnloadRenderTexture(scene->Target);
+
+    ui_exit(scene->UI);
+    free(scene->UI);
+
+    game_exit(scene->Game);
+    free(scene->Game);
+
+    parallax_band_exit(&scene->Woods);
+    parallax_band_exit(&scene->Cave);
+    render_queue_exit(&scene->Queue);
+}
+
+static void accumulate_stats(BenchResult* result, const RenderStats* stats) {
+    result->Commands += stats->Commands;
+    result->DrawCalls += stats->DrawCalls;
+    result->BatchFlushes += stats->BatchFlushes;
+    result->TextureBinds += stats->TextureBinds;
+    result->Rectangles += stats->Rectangles;
+    result->Circles += stats->Circles;
+    result->Sprites += stats->Sprites;
+    result->Texts += stats->Texts;
+    result->Quads += stats->Quads;
+}
+
+// The camera goes from the start of the level to its end once over frameCount frames
+static BenchResult run_level(BenchScene* scene, const char* name, const LevelData* level, int frameCount, double* frameTimes) {
+    BenchResult result = { 0 };
+    snprintf(result.Name, sizeof(result.Name), "%s", name);
+    result.FrameCount = frameCount;
+
+    GameData* gameData = scene->Game;
+    game_init(gameData, level, scene->Palette, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+
+    const float levelEnd = level->LevelWidth * gameData->TileSize - BENCH_SCREEN_WIDTH;
+    const float playerOffset = gameData->PlayerPosX;
+    double recordTime = 0.0;
+
+    for (int frame = -BENCH_WARMUP_FRAMES; frame < frameCount; frame++) {
+        const float t = frame < 0 ? 0.0f : frame / (float)(frameCount > 1 ? frameCount - 1 : 1);
+        gameData->CameraPosX = t * (levelEnd > 0.0f ? levelEnd : 0.0f);
+        gameData->PlayerPosX = gameData->CameraPosX + playerOffset;
+
+        if (frame % BENCH_BURST_INTERVAL == 0) {
+            effects_burst(&gameData->Effects, EFFECT_ENEMY_DEATH, (Vector2){ gameData->PlayerPosX + 200.0f, BENCH_SCREEN_HEIGHT / 2.0f }, 40);
+        }
+        effects_tick(&gameData->Effects, gameData->CameraPosX, BENCH_SCREEN_WIDTH, BENCH_FRAME_DT);
+
+        const double start = thread_get_time();
+
+        render_queue_begin(&scene->Queue, 5);
+        parallax_band_draw(&scene->Woods, &scene->Queue, gameData->CameraPosX);
+        parallax_band_draw(&scene->Cave, &scene->Queue, gameData->CameraPosX);
+        game_draw(gameData, level, &scene->Queue, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+        ui_draw(scene->UI, &scene->Queue, RENDER_LAYER_UI);
+
+        const double recorded = thread_get_time();
+
+        BeginTextureMode(scene->Target);
+        render_queue_submit(&scene->Queue);
+        EndTextureMode();
+
+        // Presenting makes the driver finish the frame, llvmpipe only rasterizes when it has to
+        BeginDrawing();
+        DrawTextureRec(scene->Target.texture, (Rectangle){ 0, 0, BENCH_SCREEN_WIDTH, -BENCH_SCREEN_HEIGHT }, (Vector2){ 0, 0 }, WHITE);
+        EndDrawing();
+
+        const double end = thread_get_time();
+
+        if (frame >= 0) {
+            frameTimes[frame] = (end - start) * 1000.0;
+            recordTime += recorded - start;
+            accumulate_stats(&result, &scene->Queue.Stats);
+        }
+    }
+
+    result.RecordMs = recordTime * 1000.0 / frameCount;
+    result.Commands /= frameCount;
+    result.DrawCalls /= frameCount;
+    result.BatchFlushes /= frameCount;
+    result.TextureBinds /= frameCount;
+    result.Rectangles /= frameCount;
+    result.Circles /= frameCount;
+    result.Sprites /= frameCount;
+    result.Texts /= frameCount;
+    result.Quads /= frameCount;
+
+    double sum = 0.0;
+    for (int i = 0; i < frameCount; i++) {
+        sum += frameTimes[i];
+    }
+    result.MeanMs = sum / frameCount;
+
+    qsort(frameTimes, frameCount, sizeof(double), compare_doubles);
+    result.P99Ms = frameTimes[(frameCount * 99 + 99) / 100 - 1];
+    result.MaxMs = frameTimes[frameCount - 1];
+
+    return result;
+}
+
+static bool write_json(const char* fileName, const BenchResult* results, int resultCount) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        return false;
+    }
+
+    fprintf(file, "{\n  \"benchmark\": \"render\",\n  \"width\": %d,\n  \"height\": %d,\n  \"levels\": [\n", BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult* r = &results[i];
+
+        fprintf(file, "    { \"name\": \"%s\", \"frames\": %d, \"ms_per_frame\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f, \"record_ms\": %.3f, ",
+            r->Name, r->FrameCount, r->MeanMs, r->P99Ms, r->MaxMs, r->RecordMs);
+        fprintf(file, "\"commands\": %.1f, \"draw_calls\": %.1f, \"batch_flushes\": %.1f, \"texture_binds\": %.1f, \"rectangles\": %.1f, \"circles\": %.1f, \"sprites\": %.1f, \"texts\": %.1f, \"quads\": %.1f }%s\n",
+            r->Commands, r->DrawCalls, r->BatchFlushes, r->TextureBinds, r->Rectangles, r->Circles, r->Sprites, r->Texts, r->Quads, i + 1 < resultCount ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int frameCount = BENCH_DEFAULT_FRAMES;
+    const char* jsonFileName = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonFileName = argv[++i];
+        }
+        else {
+            printf("usage: %s [--frames N] [--json file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (frameCount < 1) frameCount = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT, "bench_render");
+    InitAudioDevice(); // game_create loads the sound effects as well
+    SetTargetFPS(0);
+
+    FilePathList levelFiles = LoadDirectoryFilesEx(BENCH_LEVEL_DIRECTORY, ".txt", false);
+    qsort(levelFiles.paths, levelFiles.count, sizeof(char*), compare_paths);
+
+    LevelData level = { 0 };
+    level.Tiles = calloc(BENCH_MAX_LEVEL_TILES, sizeof(uint16_t));
+
+    BenchScene scene = { 0 };
+    double* frameTimes = malloc(frameCount * sizeof(double));
+    BenchResult results[BENCH_MAX_LEVELS];
+    int resultCount = 0;
+
+    for (unsigned int i = 0; i < levelFiles.count && i < BENCH_MAX_LEVELS; i++) {
+        memset(level.Tiles, 0, BENCH_MAX_LEVEL_TILES * sizeof(uint16_t));
+        parse_level(levelFiles.paths[i], &level);
+
+        if (i == 0) {
+            load_scene(&scene, &level);
+        }
+
+        results[resultCount] = run_level(&scene, GetFileNameWithoutExt(levelFiles.paths[i]), &level, frameCount, frameTimes);
+        resultCount += 1;
+    }
+
+    if (resultCount > 0) {
+        unload_scene(&scene);
+    }
+
+    free(frameTimes);
+    free(level.Tiles);
+    UnloadDirectoryFiles(levelFiles);
+
+    printf("%-12s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n", "level", "ms/frame", "p99 ms", "record ms", "commands", "draws", "flushes", "binds", "rects", "sprites", "quads");
+
+    for (int i = 0; i < resultCount; i++) {
+        const BenchResult* r = &results[i];
+        printf("%-12s %9.3f %9.3f %9.3f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+            r->Name, r->MeanMs, r->P99Ms, r->RecordMs, r->Commands, r->DrawCalls, r->BatchFlushes, r->TextureBinds, r->Rectangles, r->Sprites, r->Quads);
+    }
+
+    CloseAudioDevice();
+    CloseWindow();
+
+    if (jsonFileName != NULL) {
+        if (!write_json(jsonFileName, results, resultCount)) {
+            printf("Failed to write %s\n", jsonFileName);
+            return 1;
+        }
+
+        printf("\nWrote %s\n", jsonFileName);
+    }
+
+    return 0;
+}
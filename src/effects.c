@@ -0,0 +1,197 @@
+#include "effects.h"
+
+#include <string.h>
+
+// Palette indices, see the bullet colours in game_draw
+#define EFFECT_COLOR_DUST 6
+#define EFFECT_COLOR_SPARK 3
+#define EFFECT_COLOR_DEATH 1
+#define EFFECT_COLOR_PORTAL 6
+
+static EmitterConfig effect_config(Vector2 direction, float spread, float velocityMin, float velocityMax, float ageMin, float ageMax) {
+    EmitterConfig config = { 0 };
+    config.direction = direction;
+    config.velocity = (FloatRange){ velocityMin, velocityMax };
+    config.directionAngle = (FloatRange){ -spread, spread };
+    config.velocityAngle = (FloatRange){ 0.0f, 0.0f };
+    config.offset = (FloatRange){ -2.0f, 2.0f };
+    config.size = (FloatRange){ 2.0f, 4.0f };
+    config.capacity = EFFECTS_EMITTER_CAPACITY;
+    config.Color = WHITE;
+    config.age = (FloatRange){ ageMin, ageMax };
+    config.haltTime = (FloatRange){ ageMax, ageMax };
+    config.blendMode = BLEND_ALPHA;
+
+    return config;
+}
+
+static float effects_budget_scale(const GameEffects* effects) {
+    const int softLimit = EFFECTS_PARTICLE_BUDGET / 2;
+    if (effects->LiveParticles <= softLimit) return 1.0f;
+
+    float scale = (float)(EFFECTS_PARTICLE_BUDGET - effects->LiveParticles) / (float)softLimit;
+    return scale > 0.0f ? scale : 0.0f;
+}
+
+static bool effects_in_view(const GameEffects* effects, float x) {
+    return x >= effects->ViewMinX && x <= effects->ViewMaxX;
+}
+
+static bool effects_enabled(const GameEffects* effects) {
+    return effects->System != NULL;
+}
+
+bool effects_create(GameEffects* effects) {
+    memset(effects, 0, sizeof(GameEffects));
+
+    effects->Pool = EmitterPool_New(EFFECT_COUNT, EFFECTS_EMITTER_CAPACITY);
+    effects->System = ParticleSystem_New();
+    effects->ViewMaxX = 1e9f;
+
+    if (effects->Pool == NULL || effects->System == NULL) {
+        TraceLog(LOG_WARNING, "EFFECTS: Failed to allocate the emitter pool, particle effects are disabled");
+        effects_exit(effects);
+        return false;
+    }
+
+    EmitterConfig configs[EFFECT_COUNT];
+
+    // Dust kicks away from the surface the character jumps off, top character runs upside down
+    configs[EFFECT_JUMP_DUST_TOP] = effect_config((Vector2){ 0.0f, -1.0f }, 70.0f, 20.0f, 60.0f, 0.2f, 0.4f);
+    configs[EFFECT_JUMP_DUST_TOP].externalAcceleration = (Vector2){ 0.0f, 60.0f };
+    configs[EFFECT_JUMP_DUST_BOTTOM] = effect_config((Vector2){ 0.0f, 1.0f }, 70.0f, 20.0f, 60.0f, 0.2f, 0.4f);
+    configs[EFFECT_JUMP_DUST_BOTTOM].externalAcceleration = (Vector2){ 0.0f, -60.0f };
+
+    configs[EFFECT_BULLET_IMPACT] = effect_config((Vector2){ -1.0f, 0.0f }, 45.0f, 80.0f, 180.0f, 0.1f, 0.25f);
+    configs[EFFECT_BULLET_IMPACT].size = (FloatRange){ 1.0f, 3.0f };
+
+    configs[EFFECT_ENEMY_DEATH] = effect_config((Vector2){ 1.0f, 0.0f }, 180.0f, 40.0f, 160.0f, 0.3f, 0.7f);
+    configs[EFFECT_ENEMY_DEATH].size = (FloatRange){ 2.0f, 6.0f };
+    configs[EFFECT_ENEMY_DEATH].haltTime = (FloatRange){ 0.2f, 0.4f };
+
+    // Sparkles drift from the portals towards the middle of the screen
+    configs[EFFECT_PORTAL_TOP] = effect_config((Vector2){ 0.0f, 1.0f }, 40.0f, 10.0f, 40.0f, 0.4f, 0.9f);
+    configs[EFFECT_PORTAL_TOP].offset = (FloatRange){ -12.0f, 12.0f };
+    configs[EFFECT_PORTAL_TOP].size = (FloatRange){ 1.0f, 3.0f };
+    configs[EFFECT_PORTAL_TOP].blendMode = BLEND_ADDITIVE;
+    configs[EFFECT_PORTAL_BOTTOM] = configs[EFFECT_PORTAL_TOP];
+    configs[EFFECT_PORTAL_BOTTOM].direction = (Vector2){ 0.0f, -1.0f };
+
+    effects->ColorIndices[EFFECT_JUMP_DUST_TOP] = EFFECT_COLOR_DUST;
+    effects->ColorIndices[EFFECT_JUMP_DUST_BOTTOM] = EFFECT_COLOR_DUST;
+    effects->ColorIndices[EFFECT_BULLET_IMPACT] = EFFECT_COLOR_SPARK;
+    effects->ColorIndices[EFFECT_ENEMY_DEATH] = EFFECT_COLOR_DEATH;
+    effects->ColorIndices[EFFECT_PORTAL_TOP] = EFFECT_COLOR_PORTAL;
+    effects->ColorIndices[EFFECT_PORTAL_BOTTOM] = EFFECT_COLOR_PORTAL;
+    effects->PortalEmissionRate = 40;
+
+    for (int i = 0; i < EFFECT_COUNT; i++) {
+        effects->Emitters[i] = EmitterPool_Acquire(effects->Pool, configs[i]);
+
+        if (effects->Emitters[i] == NULL || !ParticleSystem_Register(effects->System, effects->Emitters[i])) {
+            TraceLog(LOG_WARNING, "EFFECTS: Failed to set up emitter %i, particle effects are disabled", i);
+            effects_exit(effects);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void effects_exit(GameEffects* effects) {
+    // The emitters live in the pool, freeing it releases them all
+    if (effects->System != NULL) ParticleSystem_Free(effects->System);
+    if (effects->Pool != NULL) EmitterPool_Free(effects->Pool);
+
+    memset(effects, 0, sizeof(GameEffects));
+}
+
+// Drops every live particle and stops the portals, e.g. on restart
+void effects_clear(GameEffects* effects) {
+    if (!effects_enabled(effects)) return;
+
+    for (int i = 0; i < EFFECT_COUNT; i++) {
+        effects->Emitters[i]->activeParticles = 0;
+        effects->Emitters[i]->movingParticles = 0;
+        effects->Emitters[i]->mustEmit = 0.0f;
+        Emitter_Stop(effects->Emitters[i]);
+    }
+
+    effects->LiveParticles = 0;
+}
+
+void effects_set_portal(GameEffects* effects, GameEffect portal, Vector2 position) {
+    if (!effects_enabled(effects)) return;
+
+    Emitter_Set_Origin(effects->Emitters[portal], position);
+}
+
+// Spawns up to amount particles, fewer when the budget is running full and none outside the camera window
+void effects_burst(GameEffects* effects, GameEffect effect, Vector2 position, int amount) {
+    if (!effects_enabled(effects) || !effects_in_view(effects, position.x)) return;
+
+    amount = (int)(amount * effects_budget_scale(effects));
+
+    const int headroom = EFFECTS_PARTICLE_BUDGET - effects->LiveParticles;
+    if (amount > headroom) amount = headroom;
+    if (amount <= 0) return;
+
+    Emitter* e = effects->Emitters[effect];
+    const int activeBefore = e->activeParticles;
+    Emitter_Set_Origin(e, position);
+    Emitter_Tweak_Burst(e, amount, amount);
+    Emitter_Burst(e);
+
+    // Emitter_Burst clamps to the emitter's capacity, only count what it actually spawned
+    effects->LiveParticles += e->activeParticles - activeBefore;
+}
+
+void effects_tick(GameEffects* effects, float cameraPosX, int screenWidth, float dt) {
+    if (!effects_enabled(effects)) return;
+
+    effects->ViewMinX = cameraPosX - EFFECTS_CULL_MARGIN;
+    effects->ViewMaxX = cameraPosX + screenWidth + EFFECTS_CULL_MARGIN;
+
+    // Portals only sparkle while on screen, and thin out with the rest of the budget
+    const size_t portalRate = (size_t)(effects->PortalEmissionRate * effects_budget_scale(effects));
+
+    for (int portal = EFFECT_PORTAL_TOP; portal <= EFFECT_PORTAL_BOTTOM; portal++) {
+        Emitter* e = effects->Emitters[portal];
+        e->config.emissionRate = portalRate;
+        e->isEmitting = portalRate > 0 && effects_in_view(effects, e->config.origin.x);
+    }
+
+    ParticleSystem_Update(effects->System, dt);
+
+    effects->LiveParticles = ParticleSystem_GetAllActiveParticleCount(effects->System);
+}
+
+// Copies the particles inside the camera window of the last tick into the render queue, in screen space
+void effects_draw(const GameEffects* effects, RenderQueue* renderQueue, float cameraPosX) {
+    if (!effects_enabled(effects)) return;
+
+    for (int i = 0; i < EFFECT_COUNT; i++) {
+        const Emitter* e = effects->Emitters[i];
+        if (e->activeParticles == 0) continue;
+
+        uint32_t visibleCount = 0;
+        for (int p = 0; p < e->activeParticles; p++) {
+            visibleCount += effects_in_view(effects, e->particlePositions[p].x);
+        }
+        if (visibleCount == 0) continue;
+
+        render_queue_set_blend_mode(renderQueue, e->config.blendMode);
+
+        RenderQuads quads = render_queue_quads(renderQueue, RENDER_LAYER_PARTICLES, visibleCount, effects->ColorIndices[i]);
+        uint32_t quad = 0;
+        for (int p = 0; p < e->activeParticles; p++) {
+            if (!effects_in_view(effects, e->particlePositions[p].x)) continue;
+
+            quads.Positions[quad] = (Vector2){ e->particlePositions[p].x - cameraPosX, e->particlePositions[p].y };
+            quads.Sizes[quad] = e->particleSizes[p];
+            quad++;
+        }
+    }
+
+    render_queue_set_blend_mode(renderQueue, BLEND_ALPHA);
+}
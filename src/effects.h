@@ -0,0 +1,54 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "particles.h"
+#include "render_queue.h"
+
+// All gameplay particles together never exceed this, whatever the scene throws at them
+#define EFFECTS_PARTICLE_BUDGET 2048
+// Per effect emitter, bounded by the budget anyway
+#define EFFECTS_EMITTER_CAPACITY 1024
+// Bursts and emitters this far outside the camera window are culled
+#define EFFECTS_CULL_MARGIN 64.0f
+
+typedef enum GameEffect {
+	EFFECT_JUMP_DUST_TOP = 0,
+	EFFECT_JUMP_DUST_BOTTOM,
+	EFFECT_BULLET_IMPACT,
+	EFFECT_ENEMY_DEATH,
+	EFFECT_PORTAL_TOP,
+	EFFECT_PORTAL_BOTTOM,
+	EFFECT_COUNT
+} GameEffect;
+
+// Particle effects in world space, ticked by game_tick and drawn through the render queue.
+// The budget works in two steps: once more than half of EFFECTS_PARTICLE_BUDGET is alive, bursts and
+// emission rates are scaled down linearly, reaching zero when the budget is full.
+// If effects_create fails to allocate, it logs a warning and returns false, and every other call is a no-op.
+typedef struct GameEffects {
+	EmitterPool* Pool;
+	ParticleSystem* System;
+	Emitter* Emitters[EFFECT_COUNT];
+	uint8_t ColorIndices[EFFECT_COUNT];
+	size_t PortalEmissionRate;
+
+	int LiveParticles;
+	float ViewMinX;
+	float ViewMaxX;
+} GameEffects;
+
+bool effects_create(GameEffects* effects);
+void effects_exit(GameEffects* effects);
+void effects_clear(GameEffects* effects);
+
+void effects_set_portal(GameEffects* effects, GameEffect portal, Vector2 position);
+void effects_burst(GameEffects* effects, GameEffect effect, Vector2 position, int amount);
+
+void effects_tick(GameEffects* effects, float cameraPosX, int screenWidth, float dt);
+void effects_draw(const GameEffects* effects, RenderQueue* renderQueue, float cameraPosX);
+
+#endif
@@ -1,4 +1,6 @@
 #include "game.h"
+#include "image_color_parser.h"
+#include "profiler.h"
 #include "utils.h"
 
 #include "raymath.h"
@@ -9,95 +11,162 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include "image_color_parser.h"
+// CPU side of the sprite sheets, filled by the asset loader between game_create and game_upload_textures
+static AssetImage CharSheetAsset;
+static AssetImage EnemySheetAsset;
+static AssetImage EnemyHitSheetAsset;
+static AssetImage PortalSheetAsset;
+
+// Sprite cache sources, in the order game_upload_textures adds them
+enum {
+    SPRITE_CHAR = 0,
+    SPRITE_ENEMY,
+    SPRITE_ENEMY_HIT,
+    SPRITE_PORTAL
+};
+
+static void set_sheet(GameData* gameData, Texture2D* sheet, int source, int frameCount, float scale) {
+    const Texture2D* textures = sprite_cache_get(&gameData->Sprites, source, gameData->TileSize * frameCount * scale, gameData->TileSize * scale);
+
+    sheet[0] = textures[0];
+    sheet[1] = textures[1];
+}
 
-void game_create(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight) {
+// Sheets follow the tile size, a level with the tile size of an earlier one reuses its textures
+static void scale_sheets(GameData* gameData) {
+    set_sheet(gameData, gameData->CharSheet, SPRITE_CHAR, gameData->CharFrameCount, 1.3f);
+    set_sheet(gameData, gameData->EnemySheet, SPRITE_ENEMY, gameData->EnemyFrameCount, 1.4f);
+    set_sheet(gameData, gameData->EnemyHitSheet, SPRITE_ENEMY_HIT, gameData->EnemyFrameCount, 1.4f);
+    set_sheet(gameData, gameData->PortalSheet, SPRITE_PORTAL, gameData->PortalFrameCount, 2.2f);
+}
+
+void game_create(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight, AssetLoader* loader) {
     const float tileSize = screenHeight / (float)levelData->LevelHeight;
     gameData->TileSize = tileSize;
 
+    effects_create(&gameData->Effects);
+
     game_restart(gameData, levelData);
 
+    // Sprite sheets are decoded and converted to palette indices by the loader at their original size,
+    // the sprite cache scales them to the tile size, see game_upload_textures.
+    // They are drawn as indexed sprites, so render_queue_set_palette recolours them with everything else.
     // player chars
-    Image tempChar = load_and_convert_image("resources/characters/goblin_run.png", allowedColors, 8);
-
     gameData->CharFrameCount = 6; // LoadImageAnim returns the wrong value :(((
 
-    ImageResize(&tempChar, tileSize * gameData->CharFrameCount * 1.3f, tileSize * 1.3f);
-    gameData->CharSheet[0] = LoadTextureFromImage(tempChar);
-
-    ImageFlipVertical(&tempChar);
-    gameData->CharSheet[1] = LoadTextureFromImage(tempChar);
-
-    UnloadImage(tempChar);
+    CharSheetAsset = (AssetImage){
+        .Path = "resources/characters/goblin_run.png",
+        .Palette = allowedColors,
+        .ColorCount = 8,
+        .Indexed = true,
+    };
+    asset_loader_add_image(loader, &CharSheetAsset);
 
     // enemies
-    Image tempEnemy = load_and_convert_image("resources/characters/wachter_side.png", allowedColors, 8);
-    Image tempHitEnemy = load_and_convert_image("resources/characters/wachter_side_hit.png", allowedColors, 8);
     gameData->EnemyFrameCount = 3;
 
-    ImageResize(&tempEnemy, tileSize * gameData->EnemyFrameCount * 1.4f, tileSize * 1.4f);
-    ImageResize(&tempHitEnemy, tileSize * gameData->EnemyFrameCount * 1.4f, tileSize * 1.4f);
-    gameData->EnemySheet[0] = LoadTextureFromImage(tempEnemy);
-    gameData->EnemyHitSheet[0] = LoadTextureFromImage(tempHitEnemy);
+    EnemySheetAsset = (AssetImage){
+        .Path = "resources/characters/wachter_side.png",
+        .Palette = allowedColors,
+        .ColorCount = 8,
+        .Indexed = true,
+    };
+    asset_loader_add_image(loader, &EnemySheetAsset);
 
-    ImageFlipVertical(&tempEnemy);
-    ImageFlipVertical(&tempHitEnemy);
-    gameData->EnemySheet[1] = LoadTextureFromImage(tempEnemy);
-    gameData->EnemyHitSheet[1] = LoadTextureFromImage(tempHitEnemy);
-
-    UnloadImage(tempEnemy);
-    UnloadImage(tempHitEnemy);
+    EnemyHitSheetAsset = EnemySheetAsset;
+    EnemyHitSheetAsset.Path = "resources/characters/wachter_side_hit.png";
+    asset_loader_add_image(loader, &EnemyHitSheetAsset);
 
     // portal
-    Image tempPortal = LoadImage("resources/images/portal.png");
     gameData->PortalFrameCount = 8;
 
-    ImageResize(&tempPortal, tileSize * gameData->PortalFrameCount * 2.2f, tileSize * 2.2f);
-    ImageFlipHorizontal(&tempPortal);
-    gameData->PortalSheet[0] = LoadTextureFromImage(tempPortal);
+    PortalSheetAsset = (AssetImage){
+        .Path = "resources/images/portal.png",
+        .Palette = allowedColors,
+        .ColorCount = 8,
+        .Indexed = true,
+        .FlipHorizontal = true,
+    };
+    asset_loader_add_image(loader, &PortalSheetAsset);
 
-    ImageFlipVertical(&tempPortal);
-    gameData->PortalSheet[1] = LoadTextureFromImage(tempPortal);
+    // sound
+    const char* jumpSounds[] = { "resources/sound/hop_top_1.wav", "resources/sound/hop_top_2.wav", "resources/sound/hop_top_3.wav" };
+    const char* portalSound = "resources/sound/portal.wav";
+    const char* respawnSound = "resources/sound/respawn.wav";
+
+    sound_pool_init(&gameData->Sounds);
+
+    uint8_t effect = sound_pool_add_effect(&gameData->Sounds, jumpSounds, 3, 0.05f, true);
+    assert(effect == GAME_SOUND_JUMP);
+    effect = sound_pool_add_effect(&gameData->Sounds, &portalSound, 1, 0.0f, false);
+    assert(effect == GAME_SOUND_PORTAL);
+    effect = sound_pool_add_effect(&gameData->Sounds, &respawnSound, 1, 0.0f, true);
+    assert(effect == GAME_SOUND_RESPAWN);
+    (void)effect;
+}
 
-    UnloadImage(tempPortal);
+// Runs on the main thread once the loader queued by game_create has finished
+void game_upload_textures(GameData* gameData, Color* allowedColors) {
+    sprite_cache_init(&gameData->Sprites);
+    sprite_cache_add_source(&gameData->Sprites, CharSheetAsset.Image);
+    sprite_cache_add_source(&gameData->Sprites, EnemySheetAsset.Image);
+    sprite_cache_add_source(&gameData->Sprites, EnemyHitSheetAsset.Image);
+    sprite_cache_add_source(&gameData->Sprites, PortalSheetAsset.Image);
 
-    // sound
-    gameData->JumpSoundTop[0] = LoadSound("resources/sound/hop_top_1.wav");
-    gameData->JumpSoundTop[1] = LoadSound("resources/sound/hop_top_2.wav");
-    gameData->JumpSoundTop[2] = LoadSound("resources/sound/hop_top_3.wav");
+    scale_sheets(gameData);
+
+    // tether: one period of the (x + y) % 3 pattern, columns -2..2 map to colors 0..4
+    Image tempTether = GenImageColor(5, 3, BLANK);
 
-    gameData->Respawn = LoadSound("resources/sound/respawn.wav");
-    gameData->Portal = LoadSound("resources/sound/portal.wav");
+    for (int y = 0; y < 3; y++) {
+        for (int x = -2; x <= 2; x++) {
+            if ((x + y + 3) % 3 == 0) {
+                ImageDrawPixel(&tempTether, x + 2, y, allowedColors[x + 2]);
+            }
+        }
+    }
+
+    convert_image_to_indices(&tempTether, allowedColors, 8);
+    gameData->TetherTexture = LoadTextureFromImage(tempTether);
+    SetTextureWrap(gameData->TetherTexture, TEXTURE_WRAP_REPEAT);
+
+    UnloadImage(tempTether);
 }
 
 void game_init(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight) {
     const float tileSize = screenHeight / (float)levelData->LevelHeight;
     gameData->TileSize = tileSize;
 
+    scale_sheets(gameData);
+
     game_restart(gameData, levelData); 
 }
 
 void game_exit(GameData* gameData) {
-    UnloadTexture(gameData->CharSheet[0]);
-    UnloadTexture(gameData->CharSheet[1]);
-    UnloadTexture(gameData->EnemySheet[0]);
-    UnloadTexture(gameData->EnemySheet[1]);
-    UnloadTexture(gameData->EnemyHitSheet[0]);
-    UnloadTexture(gameData->EnemyHitSheet[1]);
-    UnloadTexture(gameData->PortalSheet[0]);
-    UnloadTexture(gameData->PortalSheet[1]);
+    sprite_cache_exit(&gameData->Sprites);
+    UnloadTexture(gameData->TetherTexture);
 
-    for (int i = 0; i < 3; ++i) {
-        UnloadSound(gameData->JumpSoundTop[i]);
-    }
+    effects_exit(&gameData->Effects);
 
-    UnloadSound(gameData->Respawn);
-    UnloadSound(gameData->Portal);
+    sound_pool_exit(&gameData->Sounds);
 }
 
-void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth, int screenHeight, float dt) {  
+GameInput game_read_input(void) {
+    GameInput input = { 0 };
+
+    input.JumpPressed = IsKeyPressed(KEY_SPACE);
+    input.JumpDown = IsKeyDown(KEY_SPACE);
+    input.SwapGunPressed = IsKeyPressed(KEY_LEFT_SHIFT) || IsKeyPressed(KEY_RIGHT_SHIFT);
+    input.FirePressed = IsKeyPressed(KEY_LEFT_CONTROL) || IsKeyPressed(KEY_RIGHT_CONTROL);
+
+    return input;
+}
+
+void game_tick(GameData* gameData, const LevelData* levelData, const GameInput* input, int screenWidth, int screenHeight, float dt) {  
     gameData->Timer += dt;
 
+    effects_tick(&gameData->Effects, gameData->CameraPosX, screenWidth, dt);
+
     for (int i = 0; i < 2; ++i) {
         gameData->AnimationTimer[i] += 3.0f * dt;
 
@@ -327,7 +396,7 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
         }
     }
 
-    if (IsKeyPressed(KEY_SPACE)) {
+    if (input->JumpPressed) {
         bool jumped = false;
 
         for (int i = 0; i < 2; i++) {
@@ -336,18 +405,21 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
                 gameData->GoingUp[i] = true;
                 gameData->JumpTimer[i] = 0.0f;
                 onGround[i] = false;
+
+                // Feet of the top character are at the bottom of its tile, the bottom character's at the top
+                Vector2 feet = (Vector2){ gameData->PlayerPosX + gameData->TileSize / 2.0f, i == 0 ? gameData->PlayerPosY[0] + gameData->TileSize : gameData->PlayerPosY[1] };
+                effects_burst(&gameData->Effects, i == 0 ? EFFECT_JUMP_DUST_TOP : EFFECT_JUMP_DUST_BOTTOM, feet, 12);
                 
                 jumped = true;
             }
         }
 
         if (jumped) {
-            int randSound = GetRandomValue(0, 2);
-            PlaySound(gameData->JumpSoundTop[randSound]);
+            sound_event_push(&gameData->SoundEvents, GAME_SOUND_JUMP);
         }
     }
 
-    if (IsKeyDown(KEY_SPACE)) {
+    if (input->JumpDown) {
         for (int i = 0; i < 2; i++) {
             if (!onGround[i] && gameData->GoingUp[i] && gameData->JumpTimer[i] < 0.4f) {
                 gameData->JumpVelocity[i] += 350.0f * dt;
@@ -380,6 +452,9 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
 
     for (int i = 0; i < gameData->EnemyCount; ++i) {
         if (gameData->Enemies[i].HP <= 0) {
+            Vector2 center = (Vector2){ gameData->Enemies[i].Pos.x + gameData->TileSize / 2.0f, gameData->Enemies[i].Pos.y + gameData->TileSize / 2.0f };
+            effects_burst(&gameData->Effects, EFFECT_ENEMY_DEATH, center, 40);
+
             memcpy(gameData->Enemies + i, gameData->Enemies + (gameData->EnemyCount - 1), sizeof(Enemy));
 
             gameData->EnemyCount -= 1;
@@ -408,6 +483,8 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
             Rectangle enemyRect = (Rectangle){ gameData->Enemies[enemyI].Pos.x, gameData->Enemies[enemyI].Pos.y, gameData->TileSize, gameData->TileSize };
 
             if (CheckCollisionCircleRec(gameData->BulletPos[i], 5.0f, enemyRect)) {
+                effects_burst(&gameData->Effects, EFFECT_BULLET_IMPACT, gameData->BulletPos[i], 10);
+
                 gameData->BulletPos[i] = gameData->BulletPos[gameData->BulletCount - 1];
                 gameData->BulletCount -= 1;
 
@@ -429,11 +506,11 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
         } 
     }
 
-    if (IsKeyPressed(KEY_LEFT_SHIFT) || IsKeyPressed(KEY_RIGHT_SHIFT)) {
+    if (input->SwapGunPressed) {
         gameData->GunAtTop = !gameData->GunAtTop;
     }
 
-    if (IsKeyPressed(KEY_LEFT_CONTROL) || IsKeyPressed(KEY_RIGHT_CONTROL)) {
+    if (input->FirePressed) {
         float posY = gameData->GunAtTop ? gameData->PlayerPosY[0] + gameData->TileSize / 2.0f : gameData->PlayerPosY[1] + gameData->TileSize / 2.0f;
         gameData->BulletPos[gameData->BulletCount] = (Vector2){ gameData->PlayerPosX + gameData->TileSize, posY };
         gameData->BulletCount += 1;
@@ -446,19 +523,23 @@ void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth,
 
     if (gameData->PlayerPosX >= gameData->PortalPosX) {
         gameData->NextLevel = true;
-
-        if (!IsSoundPlaying(gameData->Portal)) {
-            PlaySound(gameData->Portal);
-        }
+        sound_event_push(&gameData->SoundEvents, GAME_SOUND_PORTAL);
     }
 }
 
-void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors) {
+// Plays and clears the sound events raised by game_tick. Main thread only.
+void game_play_sounds(GameData* gameData) {
+    sound_pool_play(&gameData->Sounds, &gameData->SoundEvents);
+}
+
+void game_draw(GameData* gameData, const LevelData* levelData, RenderQueue* renderQueue, int screenWidth, int screenHeight) {
+    PROFILE_BEGIN(PROFILE_ZONE_GAME_DRAW);
+
     const float tileSize = gameData->TileSize;
 
     // Only render the tiles that are on the screen
     int xStart = gameData->CameraPosX / tileSize;
-    int xEnd = xStart + (GetScreenWidth() / tileSize) + 2;
+    int xEnd = xStart + (screenWidth / tileSize) + 2;
 
     // TODO Find the top platform at every X pos and add some random dithering on it to improve visibility
     // Draw level
@@ -480,7 +561,7 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
                     isTop = y < levelData->LevelHeight - 1 && levelData->Tiles[x + ((y + 1) * levelData->LevelWidth)] != TILE_PLATFORM;
                 }
 
-                DrawRectangle(x * tileSize - gameData->CameraPosX - 1, y * tileSize - 1, tileSize + 2, tileSize + 2, gameColors[0]);
+                render_queue_rect(renderQueue, RENDER_LAYER_LEVEL, x * tileSize - gameData->CameraPosX - 1, y * tileSize - 1, tileSize + 2, tileSize + 2, 0);
 
                 if (isTop) {
                     for (int y2 = 0; y2 < tileSize / 7; ++y2) {
@@ -488,7 +569,7 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
                             if ((x2 / 2 + y2) % 4 == 0) {
                                 int posX = x * tileSize - gameData->CameraPosX - 1 + x2;
                                 int posY = high ? (y * tileSize + y2) : (y * tileSize + (tileSize - tileSize / 7) + y2);
-                                DrawPixel(posX, posY, gameColors[1]);
+                                render_queue_rect(renderQueue, RENDER_LAYER_LEVEL, posX, posY, 1, 1, 1);
                             }
                         }
                     }
@@ -498,7 +579,7 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
                             if ((x2 / 2 + y2) % 10 == 0) {
                                 int posX = x * tileSize - gameData->CameraPosX - 1 + x2;
                                 int posY = high ? (y * tileSize + y2) : ((y + 1) * tileSize - tileSize / 4 - tileSize / 7 + y2);
-                                DrawPixel(posX, posY, gameColors[1]);
+                                render_queue_rect(renderQueue, RENDER_LAYER_LEVEL, posX, posY, 1, 1, 1);
                             }
                         }
                     }
@@ -511,7 +592,7 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
     }
 
     // draw floor
-    DrawRectangle(0, GetScreenHeight() / 2 - tileSize / 2, GetScreenWidth(), tileSize, gameColors[0]);
+    render_queue_rect(renderQueue, RENDER_LAYER_LEVEL, 0, screenHeight / 2 - tileSize / 2, screenWidth, tileSize, 0);
 
     // draw bullets
     float radius1 = 5.0f;
@@ -519,10 +600,10 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
     float radius3 = 3.0f;
     float radius4 = 2.0f; 
     for (uint32_t i = 0; i < gameData->BulletCount; i++) {  
-        DrawCircle(gameData->BulletPos[i].x + radius1 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius1 / 2, radius1, gameColors[1]);
-        DrawCircle(gameData->BulletPos[i].x + radius2 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius2 / 2, radius2, gameColors[3]);
-        DrawCircle(gameData->BulletPos[i].x + radius3 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius3 / 2, radius3, gameColors[5]);
-        DrawCircle(gameData->BulletPos[i].x + radius4 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius4 / 2, radius4, gameColors[6]);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius1 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius1 / 2, radius1, 1);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius2 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius2 / 2, radius2, 3);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius3 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius3 / 2, radius3, 5);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius4 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius4 / 2, radius4, 6);
     }
 
     // draw enemies
@@ -534,35 +615,33 @@ void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors
 
         Texture toUse = isTop ? (isHit ? gameData->EnemyHitSheet[0] : gameData->EnemySheet[0]) : (isHit ? gameData->EnemyHitSheet[1] : gameData->EnemySheet[1]);
         
-        DrawTextureRec(toUse, (Rectangle) { gameData->TileSize * gameData->EnemyAnimationIndex * 1.4f, 0, gameData->EnemySheet[0].width / gameData->EnemyFrameCount, gameData->EnemySheet[0].height }, (Vector2) { gameData->Enemies[i].Pos.x - gameData->CameraPosX - 15.0f, gameData->Enemies[i].Pos.y + offsetY }, WHITE);
+        render_queue_indexed_sprite(renderQueue, RENDER_LAYER_ENEMIES, toUse, (Rectangle) { gameData->TileSize * gameData->EnemyAnimationIndex * 1.4f, 0, gameData->EnemySheet[0].width / gameData->EnemyFrameCount, gameData->EnemySheet[0].height }, (Vector2) { gameData->Enemies[i].Pos.x - gameData->CameraPosX - 15.0f, gameData->Enemies[i].Pos.y + offsetY });
     }
 
     // draw portals
-    DrawTextureRec(gameData->PortalSheet[0], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[0].width / gameData->PortalFrameCount, gameData->PortalSheet[0].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[0] - 30.0f }, WHITE);
-    DrawTextureRec(gameData->PortalSheet[1], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[1].width / gameData->PortalFrameCount, gameData->PortalSheet[1].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[1] - 30.0f }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_PORTALS, gameData->PortalSheet[0], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[0].width / gameData->PortalFrameCount, gameData->PortalSheet[0].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[0] - 30.0f });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_PORTALS, gameData->PortalSheet[1], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[1].width / gameData->PortalFrameCount, gameData->PortalSheet[1].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[1] - 30.0f });
+
+    effects_draw(&gameData->Effects, renderQueue, gameData->CameraPosX);
 
     // Draw char 1
-    DrawTextureRec(gameData->CharSheet[0], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[0] * 1.3f, 0, gameData->CharSheet[0].height, gameData->CharSheet[0].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[0] - 8.0f }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_CHARACTERS, gameData->CharSheet[0], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[0] * 1.3f, 0, gameData->CharSheet[0].height, gameData->CharSheet[0].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[0] - 8.0f });
 
     // Draw char 2
-    DrawTextureRec(gameData->CharSheet[1], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[1] * 1.3f, 0, gameData->CharSheet[1].height, gameData->CharSheet[1].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[1] }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_CHARACTERS, gameData->CharSheet[1], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[1] * 1.3f, 0, gameData->CharSheet[1].height, gameData->CharSheet[1].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[1] });
 
     // tether
     {
         int charStartX = (int)gameData->PlayerPosX - gameData->CameraPosX + tileSize / 2;
         int charYUp = (int)gameData->PlayerPosY[0] + tileSize;
         int charYDown = (int)gameData->PlayerPosY[1];
-        for (int x = -2; x <= 2; x++) {
-            for (int y = charYUp; y < charYDown; y++) {
-                if ((x + y) % 3 == 0) {
-                    DrawPixel(charStartX + x, y, gameColors[x+2]);
-                }        
-            }
-        }
+        game_tether_draw(gameData, renderQueue, charStartX, charYUp, charYDown);
     }
+
+    PROFILE_END(PROFILE_ZONE_GAME_DRAW);
 }
 
-void game_bladesaws_draw(GameData* gameData, Texture2D bladesaw, float dt) {
+void game_bladesaws_draw(GameData* gameData, RenderQueue* renderQueue, Texture2D bladesaw, float dt) {
     gameData->BladeSawTimer += dt;
     if (gameData->BladeSawTimer > 0.1f) {
         gameData->BladeSawTimer = 0.0f;
@@ -575,11 +654,21 @@ void game_bladesaws_draw(GameData* gameData, Texture2D bladesaw, float dt) {
     Rectangle blades = (Rectangle){ gameData->BladeSawRectIndex * (bladesaw.width / 2), 0, bladesaw.width / 2, bladesaw.height };
     float startPosY = -bladesaw.height / 2;
 
-    DrawTextureRec(bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 0 }, WHITE);
-    DrawTextureRec(bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 1 }, WHITE);
-    DrawTextureRec(bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 2 }, WHITE);
-    DrawTextureRec(bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 3 }, WHITE);
-    DrawTextureRec(bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 4 }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_BLADESAWS, bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 0 });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_BLADESAWS, bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 1 });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_BLADESAWS, bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 2 });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_BLADESAWS, bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 3 });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_BLADESAWS, bladesaw, blades, (Vector2) { 0, startPosY + bladesaw.height * 4 });
+}
+
+void game_tether_draw(GameData* gameData, RenderQueue* renderQueue, int charStartX, int charYUp, int charYDown) {
+    int height = charYDown - charYUp;
+    if (height <= 0) return;
+
+    // The source rect is in pixel space and starts at charYUp, so the repeat wrap picks the same
+    // row of the pattern that (x + y) % 3 would have picked for that screen row.
+    Rectangle source = (Rectangle){ 0, charYUp, gameData->TetherTexture.width, height };
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_TETHER, gameData->TetherTexture, source, (Vector2) { charStartX - 2, charYUp });
 }
 
 void game_restart(GameData* gameData, const LevelData* levelData) {
@@ -618,6 +707,8 @@ void game_restart(GameData* gameData, const LevelData* levelData) {
     gameData->GunAtTop = true;
 
     gameData->Timer = 0.0f;
+
+    effects_clear(&gameData->Effects);
     
     for (uint16_t y = 0; y < levelData->LevelHeight; y++) {
         for (uint32_t x = 0; x < levelData->LevelWidth; x++) { 
@@ -652,4 +743,7 @@ void game_restart(GameData* gameData, const LevelData* levelData) {
             }
         }
     }
+
+    effects_set_portal(&gameData->Effects, EFFECT_PORTAL_TOP, (Vector2){ gameData->PortalPosX + gameData->TileSize / 2.0f, gameData->PortalPosY[0] });
+    effects_set_portal(&gameData->Effects, EFFECT_PORTAL_BOTTOM, (Vector2){ gameData->PortalPosX + gameData->TileSize / 2.0f, gameData->PortalPosY[1] + gameData->TileSize });
 }
\ No newline at end of file
@@ -2,6 +2,11 @@
 #define GAME_H
 #include <raylib.h>
 #include "level_parser.h"
+#include "render_queue.h"
+#include "effects.h"
+#include "asset_loader.h"
+#include "sprite_cache.h"
+#include "sound_pool.h"
 #include <stdbool.h>
 
 #define MAX_ENEMIES 50
@@ -15,6 +20,20 @@ typedef struct Enemy {
 	float PosOffsetTimer; 
 } Enemy;
 
+// Input is sampled on the main thread and handed to game_tick, which may run on the simulation thread
+typedef struct GameInput {
+	bool JumpPressed;
+	bool JumpDown;
+	bool SwapGunPressed;
+	bool FirePressed;
+} GameInput;
+
+// game_tick doesn't touch the audio device, it queues these and the main thread plays them.
+// Effect ids in GameData.Sounds, in the order game_create adds them.
+#define GAME_SOUND_JUMP    0
+#define GAME_SOUND_PORTAL  1
+#define GAME_SOUND_RESPAWN 2
+
 typedef struct GameData {
 	bool NextLevel;
 	bool RestartLevel;
@@ -62,17 +81,26 @@ typedef struct GameData {
 	float PortalAnimationTimer;
 	int PortalAnimationIndex;
 
-	Sound JumpSoundTop[3];
-	Sound Portal;
-	Sound Respawn;
+	Texture TetherTexture; // 5 x 3 repeating tether pattern, drawn as a single quad
+
+	SpriteCache Sprites; // Owns the sheet textures above, in every tile size used so far
+
+	GameEffects Effects;
+
+	SoundEventQueue SoundEvents;
+	SoundPool Sounds;
 } GameData;
 
-void game_create(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight);
+void game_create(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight, AssetLoader* loader);
+void game_upload_textures(GameData* gameData, Color* allowedColors);
 void game_init(GameData* gameData, const LevelData* levelData, Color* allowedColors, int screenWidth, int screenHeight);
 void game_exit(GameData* gameData);
-void game_tick(GameData* gameData, const LevelData* levelData, int screenWidth, int screenHeight, float dt);
-void game_draw(GameData* gameData, const LevelData* levelData, Color* gameColors);
-void game_bladesaws_draw(GameData* gameData, Texture2D bladesaw, float dt);
+GameInput game_read_input(void);
+void game_tick(GameData* gameData, const LevelData* levelData, const GameInput* input, int screenWidth, int screenHeight, float dt);
+void game_play_sounds(GameData* gameData);
+void game_draw(GameData* gameData, const LevelData* levelData, RenderQueue* renderQueue, int screenWidth, int screenHeight);
+void game_bladesaws_draw(GameData* gameData, RenderQueue* renderQueue, Texture2D bladesaw, float dt);
+void game_tether_draw(GameData* gameData, RenderQueue* renderQueue, int charStartX, int charYUp, int charYDown);
 
 void game_restart(GameData* gameData, const LevelData* levelData);
 
@@ -1,5 +1,134 @@
 #include "image_color_parser.h"
 
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define COLOR_PARSER_SIMD_SSE
+	#include <emmintrin.h>
+#endif
+
+// RGB -> palette index lookup, 5 bits per channel. A cell only stores an index when all of its
+// 8 x 8 x 8 colours have the same nearest palette colour, otherwise it holds LUT_AMBIGUOUS and the
+// pixel falls back to the exact search. Nearest colour regions are convex, so checking the 8 corners
+// of a cell is enough, which keeps the output identical to searching every pixel.
+#define LUT_BITS 5
+#define LUT_SIZE (1 << (3 * LUT_BITS))
+#define LUT_AMBIGUOUS 0xFF
+
+static uint8_t PaletteLut[LUT_SIZE];
+static Color LutPalette[LUT_AMBIGUOUS];
+static uint8_t LutColorCount = 0;
+
+static uint8_t find_nearest_color(int r, int g, int b, const Color* allowed_colors, uint8_t color_count) {
+	float bestDiffValue = 999999.9f;
+	uint8_t bestColorIndex = 0;
+	for (uint8_t c = 0; c < color_count; c++) {
+		Color testColor = allowed_colors[c];
+
+		float diffValue = ((r - testColor.r) * (r - testColor.r))
+			+ ((g - testColor.g) * (g - testColor.g))
+			+ ((b - testColor.b) * (b - testColor.b));
+
+		if (diffValue < bestDiffValue) {
+			bestDiffValue = diffValue;
+			bestColorIndex = c;
+		}
+	}
+
+	return bestColorIndex;
+}
+
+// Builds the lookup for a palette, or keeps the current one if the palette didn't change.
+// Call it before converting images from several threads, after that the table is only read.
+void prepare_palette_lut(const Color* allowed_colors, uint8_t color_count) {
+	if (color_count >= LUT_AMBIGUOUS) color_count = LUT_AMBIGUOUS - 1;
+
+	if (color_count == LutColorCount && memcmp(LutPalette, allowed_colors, color_count * sizeof(Color)) == 0) return;
+
+	const int cellSize = 1 << (8 - LUT_BITS);
+
+	for (int r = 0; r < (1 << LUT_BITS); r++) {
+		for (int g = 0; g < (1 << LUT_BITS); g++) {
+			for (int b = 0; b < (1 << LUT_BITS); b++) {
+				uint8_t index = find_nearest_color(r * cellSize, g * cellSize, b * cellSize, allowed_colors, color_count);
+
+				for (int corner = 1; corner < 8 && index != LUT_AMBIGUOUS; corner++) {
+					int cornerR = r * cellSize + ((corner & 1) ? cellSize - 1 : 0);
+					int cornerG = g * cellSize + ((corner & 2) ? cellSize - 1 : 0);
+					int cornerB = b * cellSize + ((corner & 4) ? cellSize - 1 : 0);
+
+					if (find_nearest_color(cornerR, cornerG, cornerB, allowed_colors, color_count) != index) {
+						index = LUT_AMBIGUOUS;
+					}
+				}
+
+				PaletteLut[(r << (2 * LUT_BITS)) | (g << LUT_BITS) | b] = index;
+			}
+		}
+	}
+
+	memcpy(LutPalette, allowed_colors, color_count * sizeof(Color));
+	LutColorCount = color_count;
+}
+
+static inline uint8_t lookup_color(uint8_t r, uint8_t g, uint8_t b) {
+	uint8_t index = PaletteLut[((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3)];
+
+	return index != LUT_AMBIGUOUS ? index : find_nearest_color(r, g, b, LutPalette, LutColorCount);
+}
+
+static void convert_pixels_rgba(uint8_t* pixels, int pixelCount) {
+	int i = 0;
+
+#if defined(COLOR_PARSER_SIMD_SSE)
+	// 4 pixels at a time: build the lookup keys and the alpha mask in registers, then gather from the table
+	const __m128i mask5 = _mm_set1_epi32(0xF8);
+	for (; i + 4 <= pixelCount; i += 4) {
+		const __m128i rgba = _mm_loadu_si128((const __m128i*)(pixels + i * 4));
+
+		const __m128i r = _mm_and_si128(rgba, mask5);
+		const __m128i g = _mm_and_si128(_mm_srli_epi32(rgba, 8), mask5);
+		const __m128i b = _mm_and_si128(_mm_srli_epi32(rgba, 16), mask5);
+		const __m128i keys = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 7), _mm_slli_epi32(g, 2)), _mm_srli_epi32(b, 3));
+		const __m128i transparent = _mm_cmpeq_epi32(_mm_srli_epi32(rgba, 24), _mm_setzero_si128());
+
+		uint32_t keyValues[4];
+		uint32_t skip[4];
+		_mm_storeu_si128((__m128i*)keyValues, keys);
+		_mm_storeu_si128((__m128i*)skip, transparent);
+
+		for (int lane = 0; lane < 4; lane++) {
+			if (skip[lane]) continue;
+
+			uint8_t* pixel = pixels + (i + lane) * 4;
+			uint8_t index = PaletteLut[keyValues[lane]];
+			if (index == LUT_AMBIGUOUS) index = find_nearest_color(pixel[0], pixel[1], pixel[2], LutPalette, LutColorCount);
+
+			memcpy(pixel, &LutPalette[index], 4);
+		}
+	}
+#endif
+
+	for (; i < pixelCount; i++) {
+		uint8_t* pixel = pixels + i * 4;
+		if (pixel[3] == 0) continue;
+
+		memcpy(pixel, &LutPalette[lookup_color(pixel[0], pixel[1], pixel[2])], 4);
+	}
+}
+
+static void convert_pixels_rgb(uint8_t* pixels, int pixelCount) {
+	for (int i = 0; i < pixelCount; i++) {
+		uint8_t* pixel = pixels + i * 3;
+		const Color color = LutPalette[lookup_color(pixel[0], pixel[1], pixel[2])];
+
+		pixel[0] = color.r;
+		pixel[1] = color.g;
+		pixel[2] = color.b;
+	}
+}
+
 Texture load_and_convert_texture(const char* path, Color* allowed_colors, uint8_t color_count) {
 	Image temp = load_and_convert_image(path, allowed_colors, color_count);
 
@@ -13,30 +142,57 @@ Texture load_and_convert_texture(const char* path, Color* allowed_colors, uint8_
 Image load_and_convert_image(const char* path, Color* allowed_colors, uint8_t color_count) {
 	Image temp = LoadImage(path);
 
+	convert_image_colors(&temp, allowed_colors, color_count);
+
+	return temp;
+}
+
+void convert_image_colors(Image* image, Color* allowed_colors, uint8_t color_count) {
+	Image temp = *image;
+
+	prepare_palette_lut(allowed_colors, color_count);
+
+	// 8 bit RGBA and RGB are converted in place, other formats go through raylib's per pixel accessors
+	if (temp.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+		convert_pixels_rgba((uint8_t*)temp.data, temp.width * temp.height);
+		return;
+	}
+
+	if (temp.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) {
+		convert_pixels_rgb((uint8_t*)temp.data, temp.width * temp.height);
+		return;
+	}
+
 	for (int y = 0; y < temp.height; y++) {
 		for (int x = 0; x < temp.width; x++) {
 			Color color = GetImageColor(temp, x, y);
 
 			if (color.a == 0) continue;
 
-			float bestDiffValue = 999999.9f;
-			uint8_t bestColorIndex = 0;
-			for (uint8_t c = 0; c < color_count; c++) {
-				Color testColor = allowed_colors[c];
+			ImageDrawPixel(&temp, x, y, LutPalette[lookup_color(color.r, color.g, color.b)]);
+		}
+	}
+}
+
+// Same quantization as convert_image_colors, but keeps the palette index instead of the colour.
+// Transparent pixels become PALETTE_INDEX_TRANSPARENT, everything else is opaque after conversion anyway.
+void convert_image_to_indices(Image* image, Color* allowed_colors, uint8_t color_count) {
+	prepare_palette_lut(allowed_colors, color_count);
 
-				float diffValue = ((color.r - testColor.r) * (color.r - testColor.r))
-					+ ((color.g - testColor.g) * (color.g - testColor.g))
-					+ ((color.b - testColor.b) * (color.b - testColor.b));
+	ImageFormat(image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
 
-				if (diffValue < bestDiffValue) {
-					bestDiffValue = diffValue;
-					bestColorIndex = c;
-				}
-			}
+	const int pixelCount = image->width * image->height;
+	const uint8_t* pixels = (const uint8_t*)image->data;
+	uint8_t* indices = RL_MALLOC(pixelCount);
 
-			ImageDrawPixel(&temp, x, y, allowed_colors[bestColorIndex]);
-		}
+	for (int i = 0; i < pixelCount; i++) {
+		const uint8_t* pixel = pixels + i * 4;
+
+		indices[i] = pixel[3] == 0 ? PALETTE_INDEX_TRANSPARENT : lookup_color(pixel[0], pixel[1], pixel[2]);
 	}
 
-	return temp;
-}
\ No newline at end of file
+	RL_FREE(image->data);
+	image->data = indices;
+	image->format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+	image->mipmaps = 1;
+}
@@ -6,4 +6,10 @@
 
 Texture load_and_convert_texture(const char* path, Color* allowed_colors, uint8_t color_count);
 Image load_and_convert_image(const char* path, Color* allowed_colors, uint8_t color_count);
+void convert_image_colors(Image* image, Color* allowed_colors, uint8_t color_count);
+void prepare_palette_lut(const Color* allowed_colors, uint8_t color_count);
+
+// Indexed images are PIXELFORMAT_UNCOMPRESSED_GRAYSCALE with a palette index per pixel, see render_queue_indexed_sprite
+#define PALETTE_INDEX_TRANSPARENT 0xFF
+void convert_image_to_indices(Image* image, Color* allowed_colors, uint8_t color_count);
 #endif
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "job_system.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "threading.h"
+
+#if !defined(PLATFORM_WEB)
+    #define SUPPORT_JOB_THREADS
+#endif
+
+#define JOB_QUEUE_INITIAL_CAPACITY 64
+
+typedef struct Job {
+	JobFunc Func;
+	void* Data;
+	int Begin;
+	int End;
+} Job;
+
+// The owner pushes and pops at Tail, thieves take from Head
+typedef struct JobQueue {
+	Mutex* Lock;
+	Job* Jobs;
+	int Head;
+	int Tail;
+	int Capacity;
+} JobQueue;
+
+typedef struct JobWorker {
+	JobSystem* System;
+	Thread* Handle;
+	int Index;
+} JobWorker;
+
+struct JobSystem {
+	JobQueue* Queues;
+	JobWorker* Workers;
+	int ThreadCount;
+	int NextQueue;
+
+	Mutex* Lock;
+	CondVar* WorkAvailable;
+	CondVar* AllDone;
+	int QueuedJobs;
+	int PendingJobs;
+	bool Quit;
+};
+
+static void job_queue_push(JobQueue* queue, Job job) {
+	mutex_lock(queue->Lock);
+
+	if (queue->Tail == queue->Capacity) {
+		if (queue->Head > 0) {
+			memmove(queue->Jobs, queue->Jobs + queue->Head, (queue->Tail - queue->Head) * sizeof(Job));
+			queue->Tail -= queue->Head;
+			queue->Head = 0;
+		}
+		else {
+			queue->Capacity *= 2;
+			queue->Jobs = realloc(queue->Jobs, queue->Capacity * sizeof(Job));
+		}
+	}
+
+	queue->Jobs[queue->Tail++] = job;
+
+	mutex_unlock(queue->Lock);
+}
+
+static bool job_queue_take(JobQueue* queue, Job* job, bool steal) {
+	mutex_lock(queue->Lock);
+
+	const bool found = queue->Tail > queue->Head;
+	if (found) {
+		*job = steal ? queue->Jobs[queue->Head++] : queue->Jobs[--queue->Tail];
+
+		if (queue->Head == queue->Tail) {
+			queue->Head = 0;
+			queue->Tail = 0;
+		}
+	}
+
+	mutex_unlock(queue->Lock);
+
+	return found;
+}
+
+static bool job_system_find_job(JobSystem* system, int queueIndex, Job* job) {
+	bool found = job_queue_take(&system->Queues[queueIndex], job, false);
+
+	for (int i = 1; !found && i < system->ThreadCount; i++) {
+		found = job_queue_take(&system->Queues[(queueIndex + i) % system->ThreadCount], job, true);
+	}
+
+	if (found) {
+		mutex_lock(system->Lock);
+		system->QueuedJobs--;
+		mutex_unlock(system->Lock);
+	}
+
+	return found;
+}
+
+static void job_system_run(JobSystem* system, const Job* job) {
+	job->Func(job->Data, job->Begin, job->End);
+
+	mutex_lock(system->Lock);
+	system->PendingJobs--;
+	if (system->PendingJobs == 0) {
+		condvar_broadcast(system->AllDone);
+	}
+	mutex_unlock(system->Lock);
+}
+
+#if defined(SUPPORT_JOB_THREADS)
+static void job_worker_main(void* arg) {
+	JobWorker* worker = (JobWorker*)arg;
+	JobSystem* system = worker->System;
+
+	while (true) {
+		Job job;
+		if (job_system_find_job(system, worker->Index, &job)) {
+			job_system_run(system, &job);
+			continue;
+		}
+
+		mutex_lock(system->Lock);
+		while (system->QueuedJobs == 0 && !system->Quit) {
+			condvar_wait(system->WorkAvailable, system->Lock);
+		}
+		const bool quit = system->Quit;
+		mutex_unlock(system->Lock);
+
+		if (quit) break;
+	}
+}
+#endif
+
+JobSystem* job_system_create(int threadCount) {
+#if !defined(SUPPORT_JOB_THREADS)
+	threadCount = 1;
+#endif
+	if (threadCount < 1) threadCount = 1;
+	if (threadCount > JOB_SYSTEM_MAX_THREADS) threadCount = JOB_SYSTEM_MAX_THREADS;
+
+	JobSystem* system = calloc(1, sizeof(JobSystem));
+	system->ThreadCount = threadCount;
+	system->Lock = mutex_create();
+	system->WorkAvailable = condvar_create();
+	system->AllDone = condvar_create();
+
+	system->Queues = calloc(threadCount, sizeof(JobQueue));
+	for (int i = 0; i < threadCount; i++) {
+		system->Queues[i].Lock = mutex_create();
+		system->Queues[i].Capacity = JOB_QUEUE_INITIAL_CAPACITY;
+		system->Queues[i].Jobs = malloc(JOB_QUEUE_INITIAL_CAPACITY * sizeof(Job));
+	}
+
+	// Workers take queues 1..N-1, queue 0 belongs to the submitting thread
+	system->Workers = calloc(threadCount, sizeof(JobWorker));
+#if defined(SUPPORT_JOB_THREADS)
+	for (int i = 1; i < threadCount; i++) {
+		system->Workers[i].System = system;
+		system->Workers[i].Index = i;
+		// A worker that fails to start only costs parallelism, its queue still gets stolen from
+		system->Workers[i].Handle = thread_create(job_worker_main, &system->Workers[i]);
+	}
+#endif
+
+	return system;
+}
+
+void job_system_destroy(JobSystem* system) {
+	mutex_lock(system->Lock);
+	system->Quit = true;
+	condvar_broadcast(system->WorkAvailable);
+	mutex_unlock(system->Lock);
+
+	for (int i = 1; i < system->ThreadCount; i++) {
+		if (system->Workers[i].Handle != NULL) {
+			thread_join(system->Workers[i].Handle);
+		}
+	}
+
+	for (int i = 0; i < system->ThreadCount; i++) {
+		mutex_destroy(system->Queues[i].Lock);
+		free(system->Queues[i].Jobs);
+	}
+
+	condvar_destroy(system->AllDone);
+	condvar_destroy(system->WorkAvailable);
+	mutex_destroy(system->Lock);
+	free(system->Workers);
+	free(system->Queues);
+	free(system);
+}
+
+int job_system_get_thread_count(const JobSystem* system) {
+	return system->ThreadCount;
+}
+
+void job_system_submit(JobSystem* system, JobFunc func, void* data, int begin, int end) {
+	const Job job = { func, data, begin, end };
+
+	// Count the job before it becomes visible, a worker that takes it right away would
+	// otherwise decrement the counters first and job_system_wait could return early
+	mutex_lock(system->Lock);
+	system->QueuedJobs++;
+	system->PendingJobs++;
+	mutex_unlock(system->Lock);
+
+	// Spread round robin, stealing evens out whatever imbalance is left
+	job_queue_push(&system->Queues[system->NextQueue], job);
+	system->NextQueue = (system->NextQueue + 1) % system->ThreadCount;
+
+	mutex_lock(system->Lock);
+	condvar_signal(system->WorkAvailable);
+	mutex_unlock(system->Lock);
+}
+
+// job_system_wait runs jobs on the calling thread until every submitted job has finished
+void job_system_wait(JobSystem* system) {
+	while (true) {
+		Job job;
+		if (job_system_find_job(system, 0, &job)) {
+			job_system_run(system, &job);
+			continue;
+		}
+
+		// Nothing left to take, sleep until the workers finish what they are running
+		mutex_lock(system->Lock);
+		while (system->PendingJobs > 0 && system->QueuedJobs == 0) {
+			condvar_wait(system->AllDone, system->Lock);
+		}
+		const bool done = system->PendingJobs == 0;
+		mutex_unlock(system->Lock);
+
+		if (done) return;
+	}
+}
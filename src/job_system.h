@@ -0,0 +1,27 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <stdbool.h>
+
+// Work-stealing thread pool for short, independent jobs.
+// Every thread owns a job queue: it pops its own newest job first and steals the oldest job from
+// another queue when its own runs dry. The thread that calls job_system_submit/job_system_wait owns
+// queue 0 and runs jobs itself while waiting, so a pool of N threads starts N - 1 workers.
+// Only one thread may submit and wait on a JobSystem at a time.
+// On PLATFORM_WEB no workers are started and every job runs inside job_system_wait.
+
+#define JOB_SYSTEM_MAX_THREADS 64
+
+typedef struct JobSystem JobSystem;
+
+// A job processes the range [begin, end) of whatever data points to
+typedef void (*JobFunc)(void* data, int begin, int end);
+
+JobSystem* job_system_create(int threadCount);
+void job_system_destroy(JobSystem* system);
+int job_system_get_thread_count(const JobSystem* system);
+
+void job_system_submit(JobSystem* system, JobFunc func, void* data, int begin, int end);
+void job_system_wait(JobSystem* system);
+
+#endif
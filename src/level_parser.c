@@ -1,11 +1,18 @@
 #include "level_parser.h"
+#include "asset_loader.h"
+#include "profiler.h"
 
 #include <stdio.h>                          // Required for: printf()
 #include <stdlib.h>                         // Required for: 
 #include <assert.h>
 
 void parse_level(const char* path, LevelData* data) {
-	char* levelTxtData = LoadFileText(path);  
+	PROFILE_BEGIN(PROFILE_ZONE_PARSE_LEVEL);
+
+	// Pack entries and loose files both end in a zero byte
+	AssetFile levelFile = asset_file_open(path);
+	const char* levelTxtData = (const char*)levelFile.Data;
+	assert(levelTxtData != NULL);
 
 	// We're going to do this in passes to avoid too much dynamic memory allocation and complicated loops
 	// Get the max width and height first
@@ -17,6 +24,12 @@ void parse_level(const char* path, LevelData* data) {
 		uint32_t widthCounter = 0;
 
 		while (true) {
+			// Read in binary, so Windows line endings show up here
+			if (levelTxtData[charCounter] == '\r') {
+				charCounter += 1;
+				continue;
+			}
+
 			if (levelTxtData[charCounter] == '\n') { 
 				height += 1;
 
@@ -53,6 +66,11 @@ void parse_level(const char* path, LevelData* data) {
 	uint32_t charCounter = 0;
 
 	while (true) {
+		if (levelTxtData[charCounter] == '\r') {
+			charCounter += 1;
+			continue;
+		}
+
 		if (levelTxtData[charCounter] == '\n') {
 			currX = 0;
 			currY += 1;
@@ -103,5 +121,7 @@ void parse_level(const char* path, LevelData* data) {
 		//assert(charCounter <= width * height);
 	}
 
-	RL_FREE(levelTxtData);
+	asset_file_close(&levelFile);
+
+	PROFILE_END(PROFILE_ZONE_PARSE_LEVEL);
 }
\ No newline at end of file
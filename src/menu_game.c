@@ -95,8 +95,7 @@ void game_menu_tick(GameData* gameData, int screenWidth, int screenHeight, float
         }
 
         if (jumped) {
-            int randSound = GetRandomValue(0, 2);
-            PlaySound(gameData->JumpSoundTop[randSound]);
+            sound_event_push(&gameData->SoundEvents, GAME_SOUND_JUMP);
         }
     }
 
@@ -158,17 +157,17 @@ void game_menu_tick(GameData* gameData, int screenWidth, int screenHeight, float
     }
 }
 
-void game_menu_draw(GameData* gameData, Color* gameColors) {
+void game_menu_draw(GameData* gameData, RenderQueue* renderQueue) {
     // draw bullets
     float radius1 = 5.0f;
     float radius2 = 4.0f;
     float radius3 = 3.0f;
     float radius4 = 2.0f; 
     for (uint32_t i = 0; i < gameData->BulletCount; i++) {  
-        DrawCircle(gameData->BulletPos[i].x + radius1 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius1 / 2, radius1, gameColors[1]);
-        DrawCircle(gameData->BulletPos[i].x + radius2 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius2 / 2, radius2, gameColors[3]);
-        DrawCircle(gameData->BulletPos[i].x + radius3 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius3 / 2, radius3, gameColors[5]);
-        DrawCircle(gameData->BulletPos[i].x + radius4 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius4 / 2, radius4, gameColors[6]);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius1 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius1 / 2, radius1, 1);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius2 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius2 / 2, radius2, 3);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius3 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius3 / 2, radius3, 5);
+        render_queue_circle(renderQueue, RENDER_LAYER_BULLETS, gameData->BulletPos[i].x + radius4 / 2 - gameData->CameraPosX, gameData->BulletPos[i].y + radius4 / 2, radius4, 6);
     }
 
     // draw enemies
@@ -178,30 +177,24 @@ void game_menu_draw(GameData* gameData, Color* gameColors) {
         float offsetY = Lerp(0.0f, isTop ? -8.0f : 8.0f, (sinf(gameData->Enemies[i].PosOffsetTimer * 3.0f) + 2) / 2.0f);
         Texture toUse = isTop ? (isHit ? gameData->EnemyHitSheet[0] : gameData->EnemySheet[0]) : (isHit ? gameData->EnemyHitSheet[1] : gameData->EnemySheet[1]);
 
-        DrawTextureRec(toUse, (Rectangle) { gameData->TileSize * gameData->EnemyAnimationIndex * 1.4f, 0, gameData->EnemySheet[0].width / gameData->EnemyFrameCount, gameData->EnemySheet[0].height }, (Vector2) { gameData->Enemies[i].Pos.x - gameData->CameraPosX - 15.0f, gameData->Enemies[i].Pos.y + offsetY }, WHITE);
+        render_queue_indexed_sprite(renderQueue, RENDER_LAYER_ENEMIES, toUse, (Rectangle) { gameData->TileSize * gameData->EnemyAnimationIndex * 1.4f, 0, gameData->EnemySheet[0].width / gameData->EnemyFrameCount, gameData->EnemySheet[0].height }, (Vector2) { gameData->Enemies[i].Pos.x - gameData->CameraPosX - 15.0f, gameData->Enemies[i].Pos.y + offsetY });
     }
 
     // draw portals
-    DrawTextureRec(gameData->PortalSheet[0], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[0].width / gameData->PortalFrameCount, gameData->PortalSheet[0].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[0] - 30.0f }, WHITE);
-    DrawTextureRec(gameData->PortalSheet[1], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[1].width / gameData->PortalFrameCount, gameData->PortalSheet[1].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[1] - 30.0f }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_PORTALS, gameData->PortalSheet[0], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[0].width / gameData->PortalFrameCount, gameData->PortalSheet[0].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[0] - 30.0f });
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_PORTALS, gameData->PortalSheet[1], (Rectangle) { gameData->TileSize* gameData->PortalAnimationIndex * 2.2f, 0, gameData->PortalSheet[1].width / gameData->PortalFrameCount, gameData->PortalSheet[1].height }, (Vector2) { gameData->PortalPosX - gameData->CameraPosX - 15.0f, gameData->PortalPosY[1] - 30.0f });
 
     // Draw char 1
-    DrawTextureRec(gameData->CharSheet[0], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[0] * 1.3f, 0, gameData->CharSheet[0].height, gameData->CharSheet[0].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[0] - 8.0f }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_CHARACTERS, gameData->CharSheet[0], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[0] * 1.3f, 0, gameData->CharSheet[0].height, gameData->CharSheet[0].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[0] - 8.0f });
 
     // Draw char 2
-    DrawTextureRec(gameData->CharSheet[1], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[1] * 1.3f, 0, gameData->CharSheet[1].height, gameData->CharSheet[1].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[1] }, WHITE);
+    render_queue_indexed_sprite(renderQueue, RENDER_LAYER_CHARACTERS, gameData->CharSheet[1], (Rectangle) { gameData->TileSize* gameData->AnimationRectIndex[1] * 1.3f, 0, gameData->CharSheet[1].height, gameData->CharSheet[1].height }, (Vector2) { gameData->PlayerPosX - gameData->CameraPosX, gameData->PlayerPosY[1] });
 
     // tether
     {
         int charStartX = (int)gameData->PlayerPosX + 23;
         int charYUp = (int)gameData->PlayerPosY[0] + 50;
         int charYDown = (int)gameData->PlayerPosY[1];
-        for (int x = -2; x <= 2; x++) {
-            for (int y = charYUp; y < charYDown; y++) {
-                if ((x + y) % 3 == 0) {
-                    DrawPixel(charStartX + x, y, gameColors[x+2]);
-                }        
-            }
-        }
+        game_tether_draw(gameData, renderQueue, charStartX, charYUp, charYDown);
     }
 }
\ No newline at end of file
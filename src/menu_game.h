@@ -8,6 +8,6 @@
 
 void game_menu_init(GameData* gameData, int screenWidth, int screenHeight);
 void game_menu_tick(GameData* gameData, int screenWidth, int screenHeight, float dt);
-void game_menu_draw(GameData* gameData, Color* gameColors);
+void game_menu_draw(GameData* gameData, RenderQueue* renderQueue);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+// Asset packer: writes every file under a directory into one pack, see asset_pack.h
+// Build with `make pack_assets PLATFORM=PLATFORM_DESKTOP`, run from src/: `pack_assets resources resources.pak`
+// Entries are LZ4 compressed when that saves at least ASSET_PACK_MIN_SAVING, which leaves already
+// compressed formats (png, mp3) stored as is so they can be served straight from the mapping.
+
+#include "raylib.h"
+#include "asset_pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASSET_PACK_MIN_SAVING 0.1f
+#define LZ4_HASH_BITS 14
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5      // The block format wants the last 5 bytes as literals
+#define LZ4_MATCH_LIMIT 12       // and no match starting in the last 12
+#define LZ4_MAX_OFFSET 65535
+
+typedef struct PackFile {
+    AssetPackEntry Entry;
+    unsigned char* Data;         // What ends up in the pack, compressed or not
+} PackFile;
+
+static unsigned int lz4_read32(const unsigned char* p) {
+    unsigned int value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static unsigned char* lz4_write_length(unsigned char* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+static unsigned char* lz4_write_sequence(unsigned char* op, const unsigned char* literals, size_t literalCount, size_t offset, size_t matchLength) {
+    unsigned char* token = op++;
+
+    *token = (unsigned char)((literalCount >= 15 ? 15 : literalCount) << 4);
+    if (literalCount >= 15) op = lz4_write_length(op, literalCount - 15);
+
+    memcpy(op, literals, literalCount);
+    op += literalCount;
+
+    // Only the last sequence goes without a match
+    if (matchLength == 0) return op;
+
+    *op++ = (unsigned char)(offset & 0xFF);
+    *op++ = (unsigned char)(offset >> 8);
+
+    matchLength -= LZ4_MIN_MATCH;
+    *token |= (unsigned char)(matchLength >= 15 ? 15 : matchLength);
+    if (matchLength >= 15) op = lz4_write_length(op, matchLength - 15);
+
+    return op;
+}
+
+static int lz4_compress_bound(int size) {
+    return size + size / 255 + 16;
+}
+
+// Greedy LZ4 block compressor with a single hash table, the decoder is lz4_decompress in asset_pack.c
+static int lz4_compress(const unsigned char* src, int size, unsigned char* dst) {
+    static int table[1 << LZ4_HASH_BITS];
+    for (int i = 0; i < (1 << LZ4_HASH_BITS); i++) table[i] = -1;
+
+    unsigned char* op = dst;
+    int anchor = 0;
+    int ip = 0;
+
+    while (ip < size - LZ4_MATCH_LIMIT) {
+        const unsigned int sequence = lz4_read32(src + ip);
+        const unsigned int hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+        const int candidate = table[hash];
+        table[hash] = ip;
+
+        if (candidate < 0 || ip - candidate > LZ4_MAX_OFFSET || lz4_read32(src + candidate) != sequence) {
+            ip++;
+            continue;
+        }
+
+        int length = LZ4_MIN_MATCH;
+        while (ip + length < size - LZ4_LAST_LITERALS && src[candidate + length] == src[ip + length]) length++;
+
+        op = lz4_write_sequence(op, src + anchor, ip - anchor, ip - candidate, length);
+        ip += length;
+        anchor = ip;
+    }
+
+    op = lz4_write_sequence(op, src + anchor, size - anchor, 0, 0);
+
+    return (int)(op - dst);
+}
+
+static int compare_entries(const void* a, const void* b) {
+    return strcmp(((const PackFile*)a)->Entry.Name, ((const PackFile*)b)->Entry.Name);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("usage: pack_assets <directory> <pack>\n");
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    FilePathList paths = LoadDirectoryFilesEx(argv[1], NULL, true);
+    PackFile* files = calloc(paths.count > 0 ? paths.count : 1, sizeof(PackFile));
+    int fileCount = 0;
+
+    for (unsigned int i = 0; i < paths.count; i++) {
+        const char* path = paths.paths[i];
+        if (GetFileName(path)[0] == '.') continue;
+
+        PackFile* file = &files[fileCount];
+
+        if (strlen(path) >= ASSET_PACK_MAX_NAME) {
+            printf("skipping %s, the name is too long\n", path);
+            continue;
+        }
+
+        // Names are looked up with the paths the game uses, which always have forward slashes
+        strcpy(file->Entry.Name, path);
+        for (char* c = file->Entry.Name; *c != '\0'; c++) {
+            if (*c == '\\') *c = '/';
+        }
+
+        int size = 0;
+        unsigned char* data = LoadFileData(path, &size);
+        if (data == NULL) continue;
+
+        unsigned char* packed = malloc(lz4_compress_bound(size));
+        const int packedSize = lz4_compress(data, size, packed);
+
+        file->Entry.Size = (uint32_t)size;
+
+        if (packedSize <= size * (1.0f - ASSET_PACK_MIN_SAVING)) {
+            file->Entry.Flags = ASSET_PACK_ENTRY_LZ4;
+            file->Entry.PackedSize = (uint32_t)packedSize;
+            file->Data = packed;
+            UnloadFileData(data);
+        }
+        else {
+            file->Entry.PackedSize = (uint32_t)size;
+            file->Data = malloc(size > 0 ? size : 1);
+            memcpy(file->Data, data, size);
+            free(packed);
+            UnloadFileData(data);
+        }
+
+        fileCount++;
+    }
+
+    UnloadDirectoryFiles(paths);
+
+    // The reader binary searches the table of contents
+    qsort(files, fileCount, sizeof(PackFile), compare_entries);
+
+    uint64_t offset = sizeof(AssetPackHeader) + (uint64_t)fileCount * sizeof(AssetPackEntry);
+    uint64_t totalSize = 0;
+
+    for (int i = 0; i < fileCount; i++) {
+        offset = (offset + ASSET_PACK_ALIGNMENT - 1) & ~(uint64_t)(ASSET_PACK_ALIGNMENT - 1);
+        files[i].Entry.Offset = offset;
+        offset += files[i].Entry.PackedSize + 1; // Zero byte after every entry
+        totalSize += files[i].Entry.Size;
+    }
+
+    FILE* out = fopen(argv[2], "wb");
+    if (out == NULL) {
+        printf("can't write %s\n", argv[2]);
+        return 1;
+    }
+
+    AssetPackHeader header = { ASSET_PACK_MAGIC, ASSET_PACK_VERSION, (uint32_t)fileCount, 0 };
+    fwrite(&header, sizeof(header), 1, out);
+
+    for (int i = 0; i < fileCount; i++) {
+        fwrite(&files[i].Entry, sizeof(AssetPackEntry), 1, out);
+    }
+
+    const unsigned char zeros[ASSET_PACK_ALIGNMENT] = { 0 };
+    uint64_t position = sizeof(AssetPackHeader) + (uint64_t)fileCount * sizeof(AssetPackEntry);
+
+    for (int i = 0; i < fileCount; i++) {
+        fwrite(zeros, 1, (size_t)(files[i].Entry.Offset - position), out);
+        fwrite(files[i].Data, 1, files[i].Entry.PackedSize, out);
+        fwrite(zeros, 1, 1, out);
+        position = files[i].Entry.Offset + files[i].Entry.PackedSize + 1;
+
+        printf("%-64s %10u %10u%s\n", files[i].Entry.Name, files[i].Entry.Size, files[i].Entry.PackedSize,
+            (files[i].Entry.Flags & ASSET_PACK_ENTRY_LZ4) ? " lz4" : "");
+
+        free(files[i].Data);
+    }
+
+    fclose(out);
+    free(files);
+
+    printf("%d files, %llu bytes packed into %llu\n", fileCount, (unsigned long long)totalSize, (unsigned long long)position);
+
+    return 0;
+}
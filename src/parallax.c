@@ -0,0 +1,168 @@
+#include "parallax.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "image_color_parser.h"
+
+// Nearest-neighbour resample of the (vertically wrapping) source rect to a destWidth x destHeight band.
+// Sampling at texel centers gives the same texels the GPU picked with point filtering when the
+// full-size texture was stretched into the band every frame. The full texture width is kept so
+// horizontal scrolling can still wrap with TEXTURE_WRAP_REPEAT.
+static Image parallax_resample(Image source, Rectangle sourceRec, int destWidth, int destHeight, float* scaleX) {
+	ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+	*scaleX = destWidth / sourceRec.width;
+	const float scaleY = destHeight / sourceRec.height;
+
+	int width = (int)(source.width * (*scaleX) + 0.5f);
+	if (width < 1) width = 1;
+
+	Image result = GenImageColor(width, destHeight, BLANK);
+
+	const Color* srcPixels = (const Color*)source.data;
+	Color* dstPixels = (Color*)result.data;
+
+	for (int y = 0; y < destHeight; y++) {
+		int srcY = (int)(sourceRec.y + (y + 0.5f) / scaleY) % source.height;
+
+		for (int x = 0; x < width; x++) {
+			int srcX = (int)((x + 0.5f) / (*scaleX)) % source.width;
+
+			dstPixels[x + y * width] = srcPixels[srcX + srcY * source.width];
+		}
+	}
+
+	UnloadImage(source);
+
+	return result;
+}
+
+void parallax_band_init(ParallaxBand* band, Rectangle dest) {
+	memset(band, 0, sizeof(ParallaxBand));
+	band->Dest = dest;
+}
+
+// Runs on a loader thread
+static void parallax_load_layer(const AssetLoader* loader, void* asset) {
+	ParallaxLayer* layer = (ParallaxLayer*)asset;
+
+	uint64_t id = asset_hash(ASSET_HASH_SEED, layer->Path, (int)strlen(layer->Path));
+	id = asset_hash(id, &layer->Source, sizeof(layer->Source));
+	id = asset_hash(id, &layer->DestWidth, sizeof(layer->DestWidth));
+	id = asset_hash(id, &layer->DestHeight, sizeof(layer->DestHeight));
+	id = asset_hash(id, layer->Palette, layer->ColorCount * sizeof(Color));
+
+	AssetFile file = asset_file_open(layer->Path);
+	const uint64_t key = asset_hash_file(&file, id);
+
+	if (asset_cache_read(loader, id, key, &layer->CpuImage, 1)) {
+		layer->ScaleX = layer->DestWidth / layer->Source.width;
+		asset_file_close(&file);
+		return;
+	}
+
+	Image source = file.Data != NULL ? LoadImageFromMemory(GetFileExtension(layer->Path), file.Data, file.Size) : (Image){ 0 };
+	asset_file_close(&file);
+
+	// Resampling with nearest neighbour only picks existing colors, so quantizing after the resample
+	// gives the exact same result as before, on a fraction of the pixels.
+	// Layers are palette locked, so they are kept as indices and the palette is applied when drawing.
+	layer->CpuImage = parallax_resample(source, layer->Source, layer->DestWidth, layer->DestHeight, &layer->ScaleX);
+	convert_image_to_indices(&layer->CpuImage, layer->Palette, layer->ColorCount);
+
+	asset_cache_write(loader, id, key, &layer->CpuImage, 1);
+}
+
+void parallax_band_add_layer(ParallaxBand* band, AssetLoader* loader, const char* path, Rectangle source, float scrollRate, Color* allowedColors, uint8_t colorCount) {
+	assert(band->LayerCount < MAX_PARALLAX_LAYERS);
+
+	ParallaxLayer* layer = &band->Layers[band->LayerCount];
+	layer->ScrollRate = scrollRate;
+	layer->Path = path;
+	layer->Source = source;
+	layer->DestWidth = (int)band->Dest.width;
+	layer->DestHeight = (int)band->Dest.height;
+	layer->Palette = allowedColors;
+	layer->ColorCount = colorCount;
+
+	asset_loader_add(loader, parallax_load_layer, layer);
+
+	band->LayerCount += 1;
+}
+
+// Call once the asset loader has finished the band's layers
+void parallax_band_bake(ParallaxBand* band) {
+	// Layers that scroll at the same rate (and therefore got the same size) never move relative to each other,
+	// so they are composited into a single texture. Indexed pixels are either transparent or opaque, so this is exact.
+	uint8_t bakedCount = 0;
+
+	for (uint8_t i = 0; i < band->LayerCount; i++) {
+		ParallaxLayer* layer = &band->Layers[i];
+
+		if (bakedCount > 0) {
+			ParallaxLayer* below = &band->Layers[bakedCount - 1];
+
+			if (below->ScrollRate == layer->ScrollRate && below->CpuImage.width == layer->CpuImage.width) {
+				uint8_t* dst = (uint8_t*)below->CpuImage.data;
+				const uint8_t* src = (const uint8_t*)layer->CpuImage.data;
+				const int pixelCount = layer->CpuImage.width * layer->CpuImage.height;
+
+				for (int p = 0; p < pixelCount; p++) {
+					if (src[p] != PALETTE_INDEX_TRANSPARENT) dst[p] = src[p];
+				}
+
+				UnloadImage(layer->CpuImage);
+				continue;
+			}
+		}
+
+		band->Layers[bakedCount] = *layer;
+		bakedCount += 1;
+	}
+
+	band->LayerCount = bakedCount;
+
+	for (uint8_t i = 0; i < band->LayerCount; i++) {
+		ParallaxLayer* layer = &band->Layers[i];
+
+		layer->Texture = LoadTextureFromImage(layer->CpuImage);
+		SetTextureWrap(layer->Texture, TEXTURE_WRAP_REPEAT);
+
+		UnloadImage(layer->CpuImage);
+		layer->CpuImage = (Image){ 0 };
+	}
+}
+
+void parallax_band_draw(const ParallaxBand* band, RenderQueue* renderQueue, float cameraPosX) {
+	for (uint8_t i = 0; i < band->LayerCount; i++) {
+		const ParallaxLayer* layer = &band->Layers[i];
+
+		// Every layer gets its own render layer so they can't be reordered by texture
+		Rectangle source = (Rectangle){ cameraPosX * layer->ScrollRate * layer->ScaleX, 0, band->Dest.width, band->Dest.height };
+		render_queue_indexed_sprite(renderQueue, RENDER_LAYER_PARALLAX + i, layer->Texture, source, (Vector2) { band->Dest.x, band->Dest.y });
+	}
+}
+
+void parallax_band_exit(ParallaxBand* band) {
+	for (uint8_t i = 0; i < band->LayerCount; i++) {
+		UnloadTexture(band->Layers[i].Texture);
+	}
+
+	band->LayerCount = 0;
+}
+
+// The demon woods on the top half of the screen, the cave on the bottom half.
+// Parallax layers are resampled once to the half-screen they are drawn into.
+void parallax_create_game_bands(ParallaxBand* woods, ParallaxBand* cave, AssetLoader* loader, int screenWidth, int screenHeight, Color* allowedColors, uint8_t colorCount) {
+	// aspect ratio is ~4.35
+	parallax_band_init(woods, (Rectangle){ 0, 0, screenWidth, screenHeight / 2 });
+	parallax_band_add_layer(woods, loader, "resources/images/parallax/demon-woods/far.png", (Rectangle){ 0, 60, 230 * 4.35f, 180 }, 0.1f, allowedColors, colorCount);
+	parallax_band_add_layer(woods, loader, "resources/images/parallax/demon-woods/close.png", (Rectangle){ 0, 60, 230 * 4.35f, 180 }, 0.3f, allowedColors, colorCount);
+
+	// aspect ratio is ~3.56
+	parallax_band_init(cave, (Rectangle){ 0, screenHeight / 2, screenWidth, screenHeight / 2 });
+	parallax_band_add_layer(cave, loader, "resources/images/parallax/cave/2.png", (Rectangle){ 0, 30, 1080 * 3.556f, 1080 }, 0.05f, allowedColors, colorCount);
+	parallax_band_add_layer(cave, loader, "resources/images/parallax/cave/4.png", (Rectangle){ 0, 120, 830 * 3.556f, 830 }, 0.25f, allowedColors, colorCount);
+	parallax_band_add_layer(cave, loader, "resources/images/parallax/cave/7.png", (Rectangle){ 0, 70, 900 * 3.556f, 900 }, 0.9f, allowedColors, colorCount);
+}
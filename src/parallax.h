@@ -0,0 +1,43 @@
+#ifndef PARALLAX_H
+#define PARALLAX_H
+
+#include <raylib.h>
+#include <stdint.h>
+
+#include "render_queue.h"
+#include "asset_loader.h"
+
+#define MAX_PARALLAX_LAYERS 4
+
+typedef struct ParallaxLayer {
+	// Load parameters for the asset loader
+	const char* Path;
+	Rectangle Source;
+	int DestWidth;
+	int DestHeight;
+	Color* Palette;
+	uint8_t ColorCount;
+
+	Image CpuImage; // Only valid between running the asset loader and parallax_band_bake
+	Texture2D Texture; // Palette indices, see render_queue_indexed_sprite
+	float ScrollRate;
+	float ScaleX; // Source texels to destination pixels, horizontally
+} ParallaxLayer;
+
+// A band is one horizontal strip of the screen with its own stack of layers (back to front).
+// Every layer is resampled once at load time so that it maps 1:1 onto Dest.
+typedef struct ParallaxBand {
+	ParallaxLayer Layers[MAX_PARALLAX_LAYERS];
+	uint8_t LayerCount;
+	Rectangle Dest;
+} ParallaxBand;
+
+void parallax_band_init(ParallaxBand* band, Rectangle dest);
+void parallax_band_add_layer(ParallaxBand* band, AssetLoader* loader, const char* path, Rectangle source, float scrollRate, Color* allowedColors, uint8_t colorCount);
+void parallax_band_bake(ParallaxBand* band);
+void parallax_band_draw(const ParallaxBand* band, RenderQueue* renderQueue, float cameraPosX);
+void parallax_band_exit(ParallaxBand* band);
+
+void parallax_create_game_bands(ParallaxBand* woods, ParallaxBand* cave, AssetLoader* loader, int screenWidth, int screenHeight, Color* allowedColors, uint8_t colorCount);
+
+#endif
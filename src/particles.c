@@ -1,6 +1,39 @@
 #include "particles.h"
 
 #include "rlgl.h"
+#include "threading.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Particles per integration job when ParticleSystem_Update splits a large emitter
+#define PARTICLE_JOB_RANGE 16384
+
+// Amount of particles Emitter_Burst generates per bulk random fill, and the randoms each particle uses
+#define PARTICLE_BURST_CHUNK 256
+#define PARTICLE_BURST_RANDOMS 7
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PARTICLES_SIMD_SSE
+    #include <emmintrin.h>
+#endif
+
+// The AVX kernel is built into every x86 build and picked at runtime, see Particles_UseAvx,
+// so neither the Makefile nor the VS project need -mavx or /arch:AVX.
+#if defined(__AVX__)
+    #define PARTICLES_SIMD_AVX
+    #define PARTICLES_AVX_TARGET
+    #include <immintrin.h>
+#elif defined(PARTICLES_SIMD_SSE) && (defined(__GNUC__) || defined(__clang__))
+    #define PARTICLES_SIMD_AVX
+    #define PARTICLES_AVX_TARGET __attribute__((target("avx")))
+    #include <immintrin.h>
+#elif defined(PARTICLES_SIMD_SSE) && defined(_MSC_VER) && defined(_M_X64)
+    #define PARTICLES_SIMD_AVX
+    #define PARTICLES_AVX_TARGET
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
 
 // GetRandomFloat returns a random float between 0.0 and 1.0.
 float GetRandomFloat(float min, float max) {
@@ -9,6 +42,97 @@ float GetRandomFloat(float min, float max) {
     return n * range + min;
 }
 
+static uint64_t SplitMix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// ParticleRng_Seed expands a 64 bit seed into the state of all lanes.
+void ParticleRng_Seed(ParticleRng* rng, uint64_t seed) {
+    for (int word = 0; word < 4; word++) {
+        for (int lane = 0; lane < PARTICLE_RNG_LANES; lane += 2) {
+            const uint64_t bits = SplitMix64(&seed);
+            rng->state[word][lane] = (uint32_t)bits;
+            rng->state[word][lane + 1] = (uint32_t)(bits >> 32);
+        }
+    }
+}
+
+// Advances every lane one xoshiro128+ step and writes one float in [0, 1) per lane.
+static void ParticleRng_Next(ParticleRng* rng, float out[PARTICLE_RNG_LANES]) {
+    for (int lane = 0; lane < PARTICLE_RNG_LANES; lane++) {
+        uint32_t s0 = rng->state[0][lane];
+        uint32_t s1 = rng->state[1][lane];
+        uint32_t s2 = rng->state[2][lane];
+        uint32_t s3 = rng->state[3][lane];
+
+        const uint32_t result = s0 + s3;
+        const uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = (s3 << 11) | (s3 >> 21);
+
+        rng->state[0][lane] = s0;
+        rng->state[1][lane] = s1;
+        rng->state[2][lane] = s2;
+        rng->state[3][lane] = s3;
+
+        // The top 24 bits fill a float mantissa exactly
+        out[lane] = (float)(result >> 8) * (1.0f / 16777216.0f);
+    }
+}
+
+// ParticleRng_Fill writes count uniform floats in [0, 1).
+// The lanes are independent streams, so SSE2 steps all of them with one instruction per xoshiro operation.
+void ParticleRng_Fill(ParticleRng* rng, float* out, int count) {
+    int i = 0;
+
+#if defined(PARTICLES_SIMD_SSE)
+    __m128i s0 = _mm_loadu_si128((const __m128i*)rng->state[0]);
+    __m128i s1 = _mm_loadu_si128((const __m128i*)rng->state[1]);
+    __m128i s2 = _mm_loadu_si128((const __m128i*)rng->state[2]);
+    __m128i s3 = _mm_loadu_si128((const __m128i*)rng->state[3]);
+    const __m128 toUnit = _mm_set1_ps(1.0f / 16777216.0f);
+
+    for (; i + PARTICLE_RNG_LANES <= count; i += PARTICLE_RNG_LANES) {
+        const __m128i result = _mm_add_epi32(s0, s3);
+        const __m128i t = _mm_slli_epi32(s1, 9);
+        s2 = _mm_xor_si128(s2, s0);
+        s3 = _mm_xor_si128(s3, s1);
+        s1 = _mm_xor_si128(s1, s2);
+        s0 = _mm_xor_si128(s0, s3);
+        s2 = _mm_xor_si128(s2, t);
+        s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), toUnit));
+    }
+
+    _mm_storeu_si128((__m128i*)rng->state[0], s0);
+    _mm_storeu_si128((__m128i*)rng->state[1], s1);
+    _mm_storeu_si128((__m128i*)rng->state[2], s2);
+    _mm_storeu_si128((__m128i*)rng->state[3], s3);
+#endif
+
+    for (; i + PARTICLE_RNG_LANES <= count; i += PARTICLE_RNG_LANES) {
+        ParticleRng_Next(rng, out + i);
+    }
+
+    if (i < count) {
+        float tail[PARTICLE_RNG_LANES];
+        ParticleRng_Next(rng, tail);
+        memcpy(out + i, tail, (count - i) * sizeof(float));
+    }
+}
+
+static float RangeLerp(FloatRange range, float t) {
+    return range.min + t * (range.max - range.min);
+}
+
 // LinearFade fades from Color c1 to Color c2. Fraction is a value between 0 and 1.
 // The interpolation is linear.
 Color LinearFade(Color c1, Color c2, float fraction) {
@@ -47,52 +171,62 @@ float Particle_Decelerator_Sudden(Particle* p) {
     return p->age < p->haltTime ? 0.0f : 1.0f;
 }
 
-// Emitter_New creates a new Emitter object.
-Emitter* Emitter_New(EmitterConfig cfg) {
-    Emitter* e = (Emitter*)calloc(1, sizeof(Emitter));
-    if (e == NULL) {
-        return NULL;
-    }
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Emitter_GetMemorySize returns the bytes Emitter_Init needs for an emitter with the given capacity.
+// The Emitter struct comes first, followed by its particle arrays, each starting on a SIMD friendly boundary.
+size_t Emitter_GetMemorySize(size_t capacity) {
+    const size_t vector2ArraySize = AlignUp(capacity * sizeof(Vector2), PARTICLE_ARRAY_ALIGNMENT);
+    const size_t floatArraySize = AlignUp(capacity * sizeof(float), PARTICLE_ARRAY_ALIGNMENT);
+
+    return AlignUp(sizeof(Emitter), PARTICLE_ARRAY_ALIGNMENT) + 3 * vector2ArraySize + 4 * floatArraySize;
+}
+
+// Emitter_Init builds an emitter inside caller owned memory, e.g. an arena.
+// memory must be PARTICLE_ARRAY_ALIGNMENT aligned and hold Emitter_GetMemorySize(cfg.capacity) bytes.
+// Particle arrays are left uninitialized, Emitter_Burst writes every field before a particle becomes active.
+Emitter* Emitter_Init(void* memory, EmitterConfig cfg) {
+    Emitter* e = (Emitter*)memory;
+    memset(e, 0, sizeof(Emitter));
+
     e->config = cfg;
     e->offset.x = e->config.texture.width / 2.0f;
     e->offset.y = e->config.texture.height / 2.0f;
-    //e->particles = (Particle*)calloc(e->config.capacity, sizeof(Particle));
-
-    e->particlePositions = (Vector2*)calloc(e->config.capacity, sizeof(Vector2));
-    e->particleVelocities = (Vector2*)calloc(e->config.capacity, sizeof(Vector2));
-    e->particlesAccellerationExt = (Vector2*)calloc(e->config.capacity, sizeof(Vector2));
-    e->particleSizes = (float*)calloc(e->config.capacity, sizeof(float));
-    e->particleAges = (float*)calloc(e->config.capacity, sizeof(float));
-    e->particleTTL = (float*)calloc(e->config.capacity, sizeof(float));
-    e->particleHaltTimes = (float*)calloc(e->config.capacity, sizeof(float));
-
-    e->activeParticles = 0;
-
-    for (size_t i = 0; i < e->config.capacity; i++) {
-        e->particlePositions[i] = (Vector2){ 0.0f, 0.0f };
-        e->particleVelocities[i] = (Vector2){ 0.0f, 0.0f };
-        e->particlesAccellerationExt[i] = (Vector2){ 0.0f, 0.0f };
-        e->particleSizes[i] = 1.0f;
-        e->particleAges[i] = 0.0f;
-        e->particleTTL[i] = 0.0f;
-        e->particleHaltTimes[i] = 0.0f;
-    }
-
-    //if(e->particles == NULL) {
-    //    free(e);
-    //    return NULL;
-    //}
-    e->mustEmit = 0;
     // Normalize direction for future uses.
     e->config.direction = Vector2Normalize(e->config.direction);
 
-    for (size_t i = 0; i < e->config.capacity; i++) {
-        //e->particles[i] = {
-        //    .particle_Deactivator = e->config.particle_Deactivator == NULL ? Particle_DeactivatorAge : e->config.particle_Deactivator,
-        //    .particle_Decellerator = e->config.particle_Decellerator == NULL ? Particle_Decellerator_Default : e->config.particle_Decellerator,
-        //};
+    // Each emitter gets its own stream, so effects never advance the gameplay GetRandomValue sequence
+    // Emitters can be created from job threads, hence the atomic counter
+    static volatile int emitterSeedCounter = 0;
+    ParticleRng_Seed(&e->rng, 0x5EED5EED5EEDull + (uint64_t)atomic_increment(&emitterSeedCounter));
+
+    const size_t vector2ArraySize = AlignUp(cfg.capacity * sizeof(Vector2), PARTICLE_ARRAY_ALIGNMENT);
+    const size_t floatArraySize = AlignUp(cfg.capacity * sizeof(float), PARTICLE_ARRAY_ALIGNMENT);
+    unsigned char* cursor = (unsigned char*)memory + AlignUp(sizeof(Emitter), PARTICLE_ARRAY_ALIGNMENT);
+
+    e->particlePositions = (Vector2*)cursor;          cursor += vector2ArraySize;
+    e->particleVelocities = (Vector2*)cursor;         cursor += vector2ArraySize;
+    e->particlesAccellerationExt = (Vector2*)cursor;  cursor += vector2ArraySize;
+    e->particleSizes = (float*)cursor;                cursor += floatArraySize;
+    e->particleAges = (float*)cursor;                 cursor += floatArraySize;
+    e->particleTTL = (float*)cursor;                  cursor += floatArraySize;
+    e->particleHaltTimes = (float*)cursor;
+
+    return e;
+}
+
+// Emitter_New creates a new Emitter object in a single heap block.
+Emitter* Emitter_New(EmitterConfig cfg) {
+    void* allocation = malloc(Emitter_GetMemorySize(cfg.capacity) + PARTICLE_ARRAY_ALIGNMENT - 1);
+    if (allocation == NULL) {
+        return NULL;
     }
 
+    Emitter* e = Emitter_Init((void*)AlignUp((uintptr_t)allocation, PARTICLE_ARRAY_ALIGNMENT), cfg);
+    e->allocation = allocation;
+
     return e;
 }
 
@@ -125,52 +259,265 @@ void Emitter_Stop(Emitter* e) {
 }
 
 // Emitter_Free frees all allocated resources.
+// Pooled emitters go back to their pool, emitters in caller memory own nothing.
 void Emitter_Free(Emitter* e) {
-    free(e->particlePositions);
-    free(e->particleVelocities);
-    free(e->particlesAccellerationExt);
-    free(e->particleSizes);
-    free(e->particleAges);
-    free(e->particleTTL);
-    free(e->particleHaltTimes);
-    free(e);
+    if (e->pool != NULL) {
+        EmitterPool_Release(e->pool, e);
+        return;
+    }
+
+    free(e->allocation);
+}
+
+static void Emitter_MoveParticle(Emitter* e, int dst, int src) {
+    e->particlePositions[dst] = e->particlePositions[src];
+    e->particleVelocities[dst] = e->particleVelocities[src];
+    e->particlesAccellerationExt[dst] = e->particlesAccellerationExt[src];
+    e->particleSizes[dst] = e->particleSizes[src];
+    e->particleAges[dst] = e->particleAges[src];
+    e->particleTTL[dst] = e->particleTTL[src];
+    e->particleHaltTimes[dst] = e->particleHaltTimes[src];
+}
+
+static void Emitter_SwapParticles(Emitter* e, int a, int b) {
+    if (a == b) return;
+
+    Vector2 position = e->particlePositions[a];
+    Vector2 velocity = e->particleVelocities[a];
+    Vector2 acceleration = e->particlesAccellerationExt[a];
+    float size = e->particleSizes[a];
+    float age = e->particleAges[a];
+    float ttl = e->particleTTL[a];
+    float haltTime = e->particleHaltTimes[a];
+
+    Emitter_MoveParticle(e, a, b);
+
+    e->particlePositions[b] = position;
+    e->particleVelocities[b] = velocity;
+    e->particlesAccellerationExt[b] = acceleration;
+    e->particleSizes[b] = size;
+    e->particleAges[b] = age;
+    e->particleTTL[b] = ttl;
+    e->particleHaltTimes[b] = haltTime;
 }
 
 // Emitter_Burst emits a specified amount of particles at once,
 // ignoring the state of e->isEmitting. Use this for singular events
 // instead of continuous output.
 void Emitter_Burst(Emitter* e) {
-    int amount = GetRandomValue(e->config.burst.min, e->config.burst.max);
+    const EmitterConfig* cfg = &e->config;
 
-    // TODO Config is too big for this
-    for (int i = e->activeParticles; i < e->activeParticles + amount; i++) {
-        // Get a random angle to find an random velocity.
-        float randa = GetRandomFloat(e->config.directionAngle.min, e->config.directionAngle.max);
+    float amountRandom;
+    ParticleRng_Fill(&e->rng, &amountRandom, 1);
+    int amount = cfg->burst.min + (int)(amountRandom * (float)(cfg->burst.max - cfg->burst.min + 1));
+    if (amount > cfg->burst.max) amount = cfg->burst.max;
 
-        // Rotate base direction with the given angle.
-        Vector2 res = Vector2Rotate(e->config.direction, randa * DEG2RAD);
+    // Arrays are packed back to back, writing past capacity would hit the next emitter
+    const int freeParticles = (int)cfg->capacity - e->activeParticles;
+    if (amount > freeParticles) amount = freeParticles;
 
-        // Get a random value for velocity range (direction is normalized).
-        float randv = GetRandomFloat(e->config.velocity.min, e->config.velocity.max);
+    // One row of uniform randoms per particle property, filled in bulk per chunk
+    float randoms[PARTICLE_BURST_RANDOMS][PARTICLE_BURST_CHUNK];
 
-        // Get a random angle to rotate the velocity vector.
-        randa = GetRandomFloat(e->config.velocityAngle.min, e->config.velocityAngle.max);
+    for (int chunkStart = 0; chunkStart < amount; chunkStart += PARTICLE_BURST_CHUNK) {
+        int chunkCount = amount - chunkStart;
+        if (chunkCount > PARTICLE_BURST_CHUNK) chunkCount = PARTICLE_BURST_CHUNK;
 
-        float rando = GetRandomFloat(e->config.offset.min, e->config.offset.max);
+        for (int r = 0; r < PARTICLE_BURST_RANDOMS; r++) {
+            ParticleRng_Fill(&e->rng, randoms[r], chunkCount);
+        }
+
+        const int first = e->activeParticles + chunkStart;
+        for (int i = 0; i < chunkCount; i++) {
+            // Rotating by the direction angle and then by the velocity angle is one rotation by their sum
+            const float angle = (RangeLerp(cfg->directionAngle, randoms[0][i]) + RangeLerp(cfg->velocityAngle, randoms[1][i])) * DEG2RAD;
+            const float speed = RangeLerp(cfg->velocity, randoms[2][i]);
+            const float offset = RangeLerp(cfg->offset, randoms[3][i]);
+            const float c = cosf(angle);
+            const float s = sinf(angle);
+
+            const int p = first + i;
+            e->particlePositions[p] = (Vector2){ cfg->origin.x + offset, cfg->origin.y + offset };
+            e->particleVelocities[p] = (Vector2){ (cfg->direction.x * c - cfg->direction.y * s) * speed, (cfg->direction.x * s + cfg->direction.y * c) * speed };
+            e->particlesAccellerationExt[p] = cfg->externalAcceleration;
+            e->particleSizes[p] = RangeLerp(cfg->size, randoms[4][i]);
+            e->particleAges[p] = 0.0f;
+            e->particleTTL[p] = RangeLerp(cfg->age, randoms[5][i]);
+            e->particleHaltTimes[p] = RangeLerp(cfg->haltTime, randoms[6][i]);
+        }
+    }
 
-        e->particlePositions[i] = (Vector2){ e->config.origin.x + rando, e->config.origin.y + rando };
-        e->particleVelocities[i] = Vector2Rotate((Vector2){ res.x * randv, res.y * randv }, randa * DEG2RAD);
-        e->particlesAccellerationExt[i] = (Vector2){ e->config.externalAcceleration.x, e->config.externalAcceleration.y };
-        e->particleSizes[i] = GetRandomFloat(e->config.size.min, e->config.size.max);
-        e->particleAges[i] = 0.0f;
-        e->particleTTL[i] = GetRandomFloat(e->config.age.min, e->config.age.max);
-        e->particleHaltTimes[i] = GetRandomFloat(e->config.haltTime.min, e->config.haltTime.max);
+    // New particles belong to the moving range, so each one trades places with the first halted particle
+    for (int i = 0; i < amount; i++) {
+        Emitter_SwapParticles(e, e->movingParticles, e->activeParticles + i);
+        e->movingParticles++;
     }
 
     e->activeParticles += amount;
 }
 
-void Emitter_Update(Emitter* e, float dt) {
+// Emitter_Integrate_Scalar ages, halts and integrates particles [begin, end).
+static void Emitter_Integrate_Scalar(Emitter* e, int begin, int end, float dt) {
+    for (int i = begin; i < end; i++) {
+        const float age = e->particleAges[i] + dt;
+        e->particleAges[i] = age;
+
+        Vector2 vel = e->particleVelocities[i];
+        Vector2 acc = e->particlesAccellerationExt[i];
+        if (age > e->particleHaltTimes[i]) {
+            vel = (Vector2){ 0.0f, 0.0f };
+            acc = (Vector2){ 0.0f, 0.0f };
+        }
+
+        vel.x += acc.x * dt;
+        vel.y += acc.y * dt;
+        e->particleVelocities[i] = vel;
+        e->particlePositions[i].x += vel.x * dt;
+        e->particlePositions[i].y += vel.y * dt;
+    }
+}
+
+#if defined(PARTICLES_SIMD_SSE)
+// Emitter_Integrate_SSE does the same as Emitter_Integrate_Scalar, 4 particles at a time.
+// Vector2 arrays are read as interleaved floats, so the per particle halt mask is widened to xy pairs.
+// Processes [begin, end) and returns the index of the first particle it did not process.
+static int Emitter_Integrate_SSE(Emitter* e, int begin, int end, float dt) {
+    const __m128 dt4 = _mm_set1_ps(dt);
+    float* ages = e->particleAges;
+    const float* haltTimes = e->particleHaltTimes;
+    float* pos = (float*)e->particlePositions;
+    float* vel = (float*)e->particleVelocities;
+    const float* acc = (const float*)e->particlesAccellerationExt;
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 age = _mm_add_ps(_mm_loadu_ps(ages + i), dt4);
+        _mm_storeu_ps(ages + i, age);
+
+        const __m128 halted = _mm_cmpgt_ps(age, _mm_loadu_ps(haltTimes + i));
+        const __m128 haltedLo = _mm_unpacklo_ps(halted, halted);
+        const __m128 haltedHi = _mm_unpackhi_ps(halted, halted);
+
+        const int xy = 2 * i;
+        const __m128 accLo = _mm_andnot_ps(haltedLo, _mm_loadu_ps(acc + xy));
+        const __m128 accHi = _mm_andnot_ps(haltedHi, _mm_loadu_ps(acc + xy + 4));
+
+        __m128 velLo = _mm_andnot_ps(haltedLo, _mm_loadu_ps(vel + xy));
+        __m128 velHi = _mm_andnot_ps(haltedHi, _mm_loadu_ps(vel + xy + 4));
+        velLo = _mm_add_ps(velLo, _mm_mul_ps(accLo, dt4));
+        velHi = _mm_add_ps(velHi, _mm_mul_ps(accHi, dt4));
+        _mm_storeu_ps(vel + xy, velLo);
+        _mm_storeu_ps(vel + xy + 4, velHi);
+
+        _mm_storeu_ps(pos + xy, _mm_add_ps(_mm_loadu_ps(pos + xy), _mm_mul_ps(velLo, dt4)));
+        _mm_storeu_ps(pos + xy + 4, _mm_add_ps(_mm_loadu_ps(pos + xy + 4), _mm_mul_ps(velHi, dt4)));
+    }
+
+    return i;
+}
+#endif
+
+#if defined(PARTICLES_SIMD_AVX)
+// Particles_UseAvx checks once whether the CPU and the OS support AVX. Threads racing on the first call
+// all store the same answer.
+static bool Particles_UseAvx(void) {
+    static volatile int useAvx = -1;
+
+    if (useAvx < 0) {
+#if defined(__AVX__)
+        useAvx = 1;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+        useAvx = osSavesYmm && (info[2] & (1 << 28)) != 0;
+#else
+        useAvx = __builtin_cpu_supports("avx") ? 1 : 0;
+#endif
+    }
+
+    return useAvx == 1;
+}
+
+// Emitter_Integrate_AVX is the 8 wide version of Emitter_Integrate_SSE.
+// unpacklo/hi work per 128 bit lane, so the widened masks need a cross lane permute to line up with the xy data.
+PARTICLES_AVX_TARGET static int Emitter_Integrate_AVX(Emitter* e, int begin, int end, float dt) {
+    const __m256 dt8 = _mm256_set1_ps(dt);
+    float* ages = e->particleAges;
+    const float* haltTimes = e->particleHaltTimes;
+    float* pos = (float*)e->particlePositions;
+    float* vel = (float*)e->particleVelocities;
+    const float* acc = (const float*)e->particlesAccellerationExt;
+
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 age = _mm256_add_ps(_mm256_loadu_ps(ages + i), dt8);
+        _mm256_storeu_ps(ages + i, age);
+
+        const __m256 halted = _mm256_cmp_ps(age, _mm256_loadu_ps(haltTimes + i), _CMP_GT_OQ);
+        const __m256 unpackedLo = _mm256_unpacklo_ps(halted, halted);
+        const __m256 unpackedHi = _mm256_unpackhi_ps(halted, halted);
+        const __m256 haltedLo = _mm256_permute2f128_ps(unpackedLo, unpackedHi, 0x20);
+        const __m256 haltedHi = _mm256_permute2f128_ps(unpackedLo, unpackedHi, 0x31);
+
+        const int xy = 2 * i;
+        const __m256 accLo = _mm256_andnot_ps(haltedLo, _mm256_loadu_ps(acc + xy));
+        const __m256 accHi = _mm256_andnot_ps(haltedHi, _mm256_loadu_ps(acc + xy + 8));
+
+        __m256 velLo = _mm256_andnot_ps(haltedLo, _mm256_loadu_ps(vel + xy));
+        __m256 velHi = _mm256_andnot_ps(haltedHi, _mm256_loadu_ps(vel + xy + 8));
+        velLo = _mm256_add_ps(velLo, _mm256_mul_ps(accLo, dt8));
+        velHi = _mm256_add_ps(velHi, _mm256_mul_ps(accHi, dt8));
+        _mm256_storeu_ps(vel + xy, velLo);
+        _mm256_storeu_ps(vel + xy + 8, velHi);
+
+        _mm256_storeu_ps(pos + xy, _mm256_add_ps(_mm256_loadu_ps(pos + xy), _mm256_mul_ps(velLo, dt8)));
+        _mm256_storeu_ps(pos + xy + 8, _mm256_add_ps(_mm256_loadu_ps(pos + xy + 8), _mm256_mul_ps(velHi, dt8)));
+    }
+
+    _mm256_zeroupper(); // The SSE kernel runs next, MSVC doesn't insert this on its own
+    return i;
+}
+#endif
+
+// Emitter_Compact swap-removes every particle that outlived its ttl and moves particles that just halted
+// from the moving range into the halted range. Removing from the moving range takes two moves:
+// the last moving particle fills the hole, the last halted particle fills the one that leaves.
+// The index is not advanced after a move, so the particle moved in gets checked as well.
+static void Emitter_Compact(Emitter* e) {
+    int i = 0;
+    while (i < e->movingParticles) {
+        const int lastMoving = e->movingParticles - 1;
+
+        if (e->particleAges[i] > e->particleTTL[i]) {
+            Emitter_MoveParticle(e, i, lastMoving);
+            Emitter_MoveParticle(e, lastMoving, e->activeParticles - 1);
+            e->movingParticles--;
+            e->activeParticles--;
+        }
+        else if (e->particleAges[i] > e->particleHaltTimes[i]) {
+            Emitter_SwapParticles(e, i, lastMoving);
+            e->movingParticles--;
+        }
+        else {
+            i++;
+        }
+    }
+
+    i = e->movingParticles;
+    while (i < e->activeParticles) {
+        if (e->particleAges[i] > e->particleTTL[i]) {
+            Emitter_MoveParticle(e, i, e->activeParticles - 1);
+            e->activeParticles--;
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+// Emitter_Emit spawns the particles owed by the emission rate.
+static void Emitter_Emit(Emitter* e, float dt) {
     size_t emitNow = 0;
 
     if (e->isEmitting) {
@@ -184,57 +531,179 @@ void Emitter_Update(Emitter* e, float dt) {
 
         e->mustEmit -= emitNow;
     }
+}
 
-    for (int i = 0; i < e->activeParticles; i++) {
+// Emitter_Integrate steps particles [begin, end). The part inside the moving range is aged, halted and integrated
+// in one pass, halted particles only age. Dead particles are stepped too, Emitter_Compact removes them afterwards.
+static void Emitter_Integrate(Emitter* e, int begin, int end, float dt) {
+    const int movingEnd = end < e->movingParticles ? end : e->movingParticles;
+    int i = begin;
+
+#if defined(PARTICLES_SIMD_AVX)
+    if (Particles_UseAvx()) i = Emitter_Integrate_AVX(e, i, movingEnd, dt);
+#endif
+#if defined(PARTICLES_SIMD_SSE)
+    i = Emitter_Integrate_SSE(e, i, movingEnd, dt); // With AVX this picks up a tail of 4 to 7
+#endif
+    Emitter_Integrate_Scalar(e, i, movingEnd, dt);
+
+    for (i = begin > e->movingParticles ? begin : e->movingParticles; i < end; i++) {
         e->particleAges[i] += dt;
     }
+}
 
-    for (int i = 0; i < e->activeParticles; i++) {
-        if (e->particleAges[i] > e->particleTTL[i]) {
-            e->particlePositions[i] = e->particlePositions[e->activeParticles - 1];
-            e->particleVelocities[i] = e->particleVelocities[e->activeParticles - 1];
-            e->particlesAccellerationExt[i] = e->particlesAccellerationExt[e->activeParticles - 1];
-            e->particleSizes[i] = e->particleSizes[e->activeParticles - 1];
-            e->particleAges[i] = e->particleAges[e->activeParticles - 1];
-            e->particleTTL[i] = e->particleTTL[e->activeParticles - 1];
-            e->particleHaltTimes[i] = e->particleHaltTimes[e->activeParticles - 1];
+void Emitter_Update(Emitter* e, float dt) {
+    Emitter_Emit(e, dt);
+    Emitter_Integrate(e, 0, e->activeParticles, dt);
+    Emitter_Compact(e);
+}
 
-            e->activeParticles--;
+#if defined(SUPPORT_RENDER_STATS)
+static ParticleDrawObserver drawObserver = NULL;
+static void* drawObserverUser = NULL;
+
+void Particles_SetDrawObserver(ParticleDrawObserver observer, void* user) {
+    drawObserver = observer;
+    drawObserverUser = user;
+}
+
+    #define PARTICLES_OBSERVE_DRAW() do { if (drawObserver != NULL) drawObserver(drawObserverUser); } while (0)
+#else
+    #define PARTICLES_OBSERVE_DRAW() ((void)0)
+#endif
+
+// Solid particles use the default texture, every texel of it is white.
+static unsigned int Emitter_DrawTexture(const Emitter* e) {
+    return e->config.texture.id != 0 ? e->config.texture.id : rlGetTextureIdDefault();
+}
+
+// Particles_WriteQuads writes count square quads into the RL_QUADS primitive the caller has open.
+// Colour and normal are rlgl state that every vertex copies, so untextured quads cost four vertex writes.
+// The batch limit is checked per chunk instead of per vertex. Returns how often that flushed the batch.
+// The render queue draws its solid quads through this as well.
+int Particles_WriteQuads(const Vector2* positions, const float* sizes, int count, bool textured) {
+    int flushes = 0;
+
+    if (!textured) rlTexCoord2f(0.5f, 0.5f);
+
+    for (int chunkStart = 0; chunkStart < count; chunkStart += PARTICLE_DRAW_CHUNK) {
+        int chunkEnd = chunkStart + PARTICLE_DRAW_CHUNK;
+        if (chunkEnd > count) chunkEnd = count;
+
+        if (rlCheckRenderBatchLimit((chunkEnd - chunkStart) * 4)) flushes++;
+
+        for (int i = chunkStart; i < chunkEnd; i++) {
+            const float x = positions[i].x;
+            const float y = positions[i].y;
+            const float size = sizes[i];
+
+            if (textured) {
+                rlTexCoord2f(0.0f, 0.0f); rlVertex2f(x, y);
+                rlTexCoord2f(0.0f, 1.0f); rlVertex2f(x, y + size);
+                rlTexCoord2f(1.0f, 1.0f); rlVertex2f(x + size, y + size);
+                rlTexCoord2f(1.0f, 0.0f); rlVertex2f(x + size, y);
+            }
+            else {
+                rlVertex2f(x, y);
+                rlVertex2f(x, y + size);
+                rlVertex2f(x + size, y + size);
+                rlVertex2f(x + size, y);
+            }
         }
+
+        PARTICLES_OBSERVE_DRAW();
     }
 
-    // TODO, ideally, this moves particles between two arrays (moving and non-moving), or to a different section in the same array
-    for (int i = 0; i < e->activeParticles; i++) {
-        if (e->particleAges[i] > e->particleHaltTimes[i]) {
-            e->particleVelocities[i] = (Vector2){ 0.0f, 0.0f };
-            e->particlesAccellerationExt[i] = (Vector2){ 0.0f, 0.0f };
-        }
+    return flushes;
+}
+
+// Emitter_WriteQuads writes the emitter's particles in its colour, see Particles_WriteQuads.
+static int Emitter_WriteQuads(const Emitter* e) {
+    const Color emitterColor = e->config.Color;
+    rlColor4ub(emitterColor.r, emitterColor.g, emitterColor.b, emitterColor.a);
+
+    return Particles_WriteQuads(e->particlePositions, e->particleSizes, e->activeParticles, e->config.texture.id != 0);
+}
+
+// Emitter_Draw draws all active particles with the emitter's own blend mode.
+// Drawing through ParticleSystem_Draw shares the blend and texture state between emitters.
+// Returns the draw calls it issued, counted like ParticleSystem_GetDrawCallCount.
+int Emitter_Draw(Emitter* e) {
+    if (e->activeParticles == 0) {
+        return 0;
     }
 
-    for (int i = 0; i < e->activeParticles; i++) {
-        e->particleVelocities[i] = Vector2Add(e->particleVelocities[i], Vector2Multiply(e->particlesAccellerationExt[i], (Vector2) { dt, dt }));
+    BeginBlendMode(e->config.blendMode);
+    PARTICLES_OBSERVE_DRAW();
+    rlSetTexture(Emitter_DrawTexture(e));
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    const int flushes = Emitter_WriteQuads(e);
+
+    rlEnd();
+    rlSetTexture(0);
+    EndBlendMode();
+    PARTICLES_OBSERVE_DRAW();
+
+    return flushes + 1;
+}
+
+
+// EmitterPool_New allocates emitterCount emitter slots in one block, each with room for particleCapacity particles.
+EmitterPool* EmitterPool_New(int emitterCount, size_t particleCapacity) {
+    EmitterPool* pool = (EmitterPool*)calloc(1, sizeof(EmitterPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->slotSize = Emitter_GetMemorySize(particleCapacity);
+    pool->particleCapacity = particleCapacity;
+    pool->emitterCount = emitterCount;
+    pool->allocation = malloc(pool->slotSize * emitterCount + PARTICLE_ARRAY_ALIGNMENT - 1);
+    if (pool->allocation == NULL) {
+        free(pool);
+        return NULL;
     }
 
-    for (int i = 0; i < e->activeParticles; i++) {
-        e->particlePositions[i] = Vector2Add(e->particlePositions[i], Vector2Multiply(e->particleVelocities[i], (Vector2) { dt, dt }));
+    unsigned char* slots = (unsigned char*)AlignUp((uintptr_t)pool->allocation, PARTICLE_ARRAY_ALIGNMENT);
+    for (int i = emitterCount - 1; i >= 0; i--) {
+        Emitter* slot = (Emitter*)(slots + i * pool->slotSize);
+        slot->nextFree = pool->freeList;
+        pool->freeList = slot;
     }
+
+    return pool;
 }
 
-// Emitter_Draw draws all active particles.
-void Emitter_Draw(Emitter* e) {
-    BeginBlendMode(e->config.blendMode);
+// EmitterPool_Acquire builds an emitter in a free slot, without touching the heap.
+// cfg.capacity is clamped to the pool's particle capacity. Returns NULL when all slots are in use.
+Emitter* EmitterPool_Acquire(EmitterPool* pool, EmitterConfig cfg) {
+    Emitter* slot = pool->freeList;
+    if (slot == NULL) {
+        return NULL;
+    }
+    pool->freeList = slot->nextFree;
 
-    const Color emitterColor = e->config.Color;
+    if (cfg.capacity > pool->particleCapacity) cfg.capacity = pool->particleCapacity;
 
-    rlSetTexture(1);
+    Emitter* e = Emitter_Init(slot, cfg);
+    e->pool = pool;
 
-    for (int i = 0; i < e->activeParticles; i++) {
-        DrawRectangleV((Vector2){ e->particlePositions[i].x, e->particlePositions[i].y }, (Vector2){ e->particleSizes[i], e->particleSizes[i] }, emitterColor);
-    }
+    return e;
+}
 
-    rlSetTexture(0);
+// EmitterPool_Release returns an emitter's slot to the pool. Emitter_Free does this for pooled emitters.
+void EmitterPool_Release(EmitterPool* pool, Emitter* e) {
+    e->pool = NULL;
+    e->nextFree = pool->freeList;
+    pool->freeList = e;
+}
 
-   EndBlendMode();
+// EmitterPool_Free frees every slot at once, emitters still in use become invalid.
+void EmitterPool_Free(EmitterPool* pool) {
+    free(pool->allocation);
+    free(pool);
 }
 
 
@@ -250,7 +719,10 @@ ParticleSystem* ParticleSystem_New(void) {
     ps->capacity = 2;
     ps->origin = (Vector2){ .x = 0, .y = 0 };
     ps->emitters = (Emitter**)calloc(ps->capacity, sizeof(Emitter*));
-    if (ps->emitters == NULL) {
+    ps->drawOrder = (Emitter**)calloc(ps->capacity, sizeof(Emitter*));
+    if (ps->emitters == NULL || ps->drawOrder == NULL) {
+        free(ps->emitters);
+        free(ps->drawOrder);
         free(ps);
         return NULL;
     }
@@ -269,6 +741,12 @@ bool ParticleSystem_Register(ParticleSystem* ps, Emitter* emitter) {
             return false;
         }
         ps->emitters = newEmitters;
+
+        Emitter** newDrawOrder = (Emitter**)realloc(ps->drawOrder, 2 * ps->capacity * sizeof(Emitter*));
+        if (newDrawOrder == NULL) {
+            return false;
+        }
+        ps->drawOrder = newDrawOrder;
         ps->capacity *= 2;
     }
 
@@ -330,17 +808,134 @@ void ParticleSystem_Burst(ParticleSystem* ps) {
     }
 }
 
-// ParticleSystem_Draw runs Emitter_Draw on all registered Emitters.
+static uint64_t Emitter_DrawKey(const Emitter* e) {
+    return ((uint64_t)e->config.blendMode << 32) | Emitter_DrawTexture(e);
+}
+
+// ParticleSystem_Draw draws all registered Emitters, grouped by blend mode and then texture.
+// A blend mode change flushes the rlgl batch, a texture change only starts a new draw call inside it,
+// so each distinct blend mode costs one flush and each distinct (blend mode, texture) pair one draw call.
 void ParticleSystem_Draw(ParticleSystem* ps) {
+    // Stable insertion sort, emitters with the same state keep their registration order
+    size_t drawCount = 0;
     for (size_t i = 0; i < ps->length; i++) {
-        Emitter_Draw(ps->emitters[i]);
+        Emitter* e = ps->emitters[i];
+        if (e->activeParticles == 0) continue;
+
+        const uint64_t key = Emitter_DrawKey(e);
+        size_t j = drawCount;
+        while (j > 0 && Emitter_DrawKey(ps->drawOrder[j - 1]) > key) {
+            ps->drawOrder[j] = ps->drawOrder[j - 1];
+            j--;
+        }
+        ps->drawOrder[j] = e;
+        drawCount++;
     }
+
+    ps->drawCalls = 0;
+
+    for (size_t groupStart = 0; groupStart < drawCount;) {
+        const Emitter* first = ps->drawOrder[groupStart];
+        const uint64_t key = Emitter_DrawKey(first);
+
+        BeginBlendMode(first->config.blendMode);
+        PARTICLES_OBSERVE_DRAW();
+        rlSetTexture(Emitter_DrawTexture(first));
+        rlBegin(RL_QUADS);
+        rlNormal3f(0.0f, 0.0f, 1.0f);
+
+        size_t i = groupStart;
+        for (; i < drawCount && Emitter_DrawKey(ps->drawOrder[i]) == key; i++) {
+            ps->drawCalls += Emitter_WriteQuads(ps->drawOrder[i]);
+        }
+
+        rlEnd();
+        rlSetTexture(0);
+        ps->drawCalls += 1;
+
+        groupStart = i;
+    }
+
+    if (drawCount > 0) {
+        EndBlendMode();
+        PARTICLES_OBSERVE_DRAW();
+    }
+}
+
+// ParticleSystem_GetDrawCallCount returns the draw calls the last ParticleSystem_Draw issued,
+// including the ones forced by a full rlgl batch.
+int ParticleSystem_GetDrawCallCount(ParticleSystem* ps) {
+    return ps->drawCalls;
+}
+
+static void ParticleJob_UpdateEmitter(void* data, int begin, int end) {
+    (void)begin;
+    (void)end;
+    Emitter* e = (Emitter*)data;
+    Emitter_Update(e, e->jobDt);
+}
+
+static void ParticleJob_Integrate(void* data, int begin, int end) {
+    Emitter* e = (Emitter*)data;
+    Emitter_Integrate(e, begin, end, e->jobDt);
+}
+
+static void ParticleJob_Compact(void* data, int begin, int end) {
+    (void)begin;
+    (void)end;
+    Emitter_Compact((Emitter*)data);
+}
+
+// ParticleSystem_SetJobSystem makes ParticleSystem_Update run on the given pool, NULL updates serially.
+void ParticleSystem_SetJobSystem(ParticleSystem* ps, JobSystem* jobs) {
+    ps->jobs = jobs;
 }
 
 // ParticleSystem_Update runs Emitter_Update on all registered Emitters.
+// With a job system, small emitters become one job each, while large ones emit on the calling thread
+// and are integrated in PARTICLE_JOB_RANGE sized jobs, followed by a compaction job once all ranges are done.
+// Everything is joined before returning, so ParticleSystem_Draw can follow directly.
 void ParticleSystem_Update(ParticleSystem* ps, float dt) {
+    if (ps->jobs == NULL) {
+        for (size_t i = 0; i < ps->length; i++) {
+            Emitter_Update(ps->emitters[i], dt);
+        }
+        return;
+    }
+
+    bool anySplit = false;
+
     for (size_t i = 0; i < ps->length; i++) {
-        Emitter_Update(ps->emitters[i], dt);
+        Emitter* e = ps->emitters[i];
+        e->jobDt = dt;
+        e->jobSplit = e->activeParticles >= PARTICLE_JOB_RANGE;
+
+        if (!e->jobSplit) {
+            job_system_submit(ps->jobs, ParticleJob_UpdateEmitter, e, 0, 0);
+            continue;
+        }
+
+        anySplit = true;
+        Emitter_Emit(e, dt);
+
+        for (int begin = 0; begin < e->activeParticles; begin += PARTICLE_JOB_RANGE) {
+            int end = begin + PARTICLE_JOB_RANGE;
+            if (end > e->activeParticles) end = e->activeParticles;
+
+            job_system_submit(ps->jobs, ParticleJob_Integrate, e, begin, end);
+        }
+    }
+
+    job_system_wait(ps->jobs);
+
+    if (anySplit) {
+        for (size_t i = 0; i < ps->length; i++) {
+            if (ps->emitters[i]->jobSplit) {
+                job_system_submit(ps->jobs, ParticleJob_Compact, ps->emitters[i], 0, 0);
+            }
+        }
+
+        job_system_wait(ps->jobs);
     }
 }
 
@@ -348,6 +943,7 @@ void ParticleSystem_Update(ParticleSystem* ps, float dt) {
 // The emitters referenced here must be freed on their own.
 void ParticleSystem_Free(ParticleSystem* p) {
     free(p->emitters);
+    free(p->drawOrder);
     free(p);
 }
 
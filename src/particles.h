@@ -52,10 +52,18 @@
 
 #include "raylib.h"
 #include "raymath.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "job_system.h"
 //#include "KShapes.h"
 //#include "KMath.h"
 //#include <cstdlib>
 
+// Quads per rlgl batch check in Particles_WriteQuads, 4 vertices each. Fits the smaller GLES2 default batch
+#define PARTICLE_DRAW_CHUNK 1024
+
 // -----------------------------------------------------------------------
 // THIS MUST BE COMMENTED OUT
 // You need to uncomment it in some editors to enable syntax highlighting
@@ -69,11 +77,15 @@ typedef struct Particle Particle;
 typedef struct EmitterConfig EmitterConfig;
 typedef struct Emitter Emitter;
 typedef struct ParticleSystem ParticleSystem;
+typedef struct EmitterPool EmitterPool;
+typedef struct ParticleRng ParticleRng;
 
 
 // Function signatures (comments are found in implementation below)
 //----------------------------------------------------------------------------------
 float GetRandomFloat(float min, float max);
+void ParticleRng_Seed(ParticleRng* rng, uint64_t seed);
+void ParticleRng_Fill(ParticleRng* rng, float* out, int count);
 Color LinearFade(Color c1, Color c2, float fraction);
 
 // Particle functors
@@ -84,6 +96,8 @@ float Particle_Decelerator_Linear(Particle* p);
 float Particle_Decelerator_Cubic(Particle* p);
 float Particle_Decelerator_Sudden(Particle* p);
 
+size_t Emitter_GetMemorySize(size_t capacity);
+Emitter* Emitter_Init(void* memory, EmitterConfig cfg);
 Emitter* Emitter_New(EmitterConfig cfg);
 void Emitter_Tweak_Direction(Emitter* e, Vector2 dirNew);
 void Emitter_Tweak_velocity(Emitter* e, float velMin, float velMax);
@@ -95,7 +109,13 @@ void Emitter_Stop(Emitter* e);
 void Emitter_Free(Emitter* e);
 void Emitter_Burst(Emitter* e);
 void Emitter_Update(Emitter* e, float dt);
-void Emitter_Draw(Emitter* e);
+int Emitter_Draw(Emitter* e);
+int Particles_WriteQuads(const Vector2* positions, const float* sizes, int count, bool textured);
+
+EmitterPool* EmitterPool_New(int emitterCount, size_t particleCapacity);
+Emitter* EmitterPool_Acquire(EmitterPool* pool, EmitterConfig cfg);
+void EmitterPool_Release(EmitterPool* pool, Emitter* e);
+void EmitterPool_Free(EmitterPool* pool);
 
 ParticleSystem* ParticleSystem_New(void);
 bool ParticleSystem_Register(ParticleSystem* ps, Emitter* emitter);
@@ -106,10 +126,19 @@ void ParticleSystem_Stop(ParticleSystem* ps);
 void ParticleSystem_Burst(ParticleSystem* ps);
 void ParticleSystem_Draw(ParticleSystem* ps);
 void ParticleSystem_Update(ParticleSystem* ps, float dt);
+void ParticleSystem_SetJobSystem(ParticleSystem* ps, JobSystem* jobs);
 void ParticleSystem_Free(ParticleSystem* p);
 void ParticleSystem_CleanAndFree(ParticleSystem* p);
 
 int ParticleSystem_GetAllActiveParticleCount(ParticleSystem* ps);
+int ParticleSystem_GetDrawCallCount(ParticleSystem* ps);
+
+#if defined(SUPPORT_RENDER_STATS)
+// The observer is called after every blend mode change and every chunk of quads the draw functions write.
+// bench_particles samples a BatchCounter with it.
+typedef void (*ParticleDrawObserver)(void* user);
+void Particles_SetDrawObserver(ParticleDrawObserver observer, void* user);
+#endif
 
 
 #ifdef LIBPARTIKEL_IMPLEMENTATION
@@ -117,6 +146,9 @@ int ParticleSystem_GetAllActiveParticleCount(ParticleSystem* ps);
 #include "stdlib.h"
 #include "math.h"
 
+// Alignment of an emitter's memory block and of each of its particle arrays, enough for AVX loads.
+#define PARTICLE_ARRAY_ALIGNMENT 32
+
 // Utility functions * structs.
 //----------------------------------------------------------------------------------
 
@@ -192,6 +224,17 @@ struct Particle {
     float (*particle_Decellerator)(struct Particle*);
 };
 
+// ParticleRng type.
+//----------------------------------------------------------------------------------
+
+#define PARTICLE_RNG_LANES 4
+
+// ParticleRng runs PARTICLE_RNG_LANES independent xoshiro128+ streams side by side,
+// laid out so one SSE register holds the same state word of every lane.
+struct ParticleRng {
+    uint32_t state[4][PARTICLE_RNG_LANES];
+};
+
 // Emitter type.
 //----------------------------------------------------------------------------------
 
@@ -211,6 +254,29 @@ struct Emitter {
     float* particleHaltTimes;
 
     int activeParticles;
+    int movingParticles;        // [0, movingParticles) still move, the rest up to activeParticles have halted.
+
+    ParticleRng rng;            // Private random stream for spawning, see Emitter_Burst.
+
+    float jobDt;                // dt of the ParticleSystem_Update in flight.
+    bool jobSplit;              // Updated as several range jobs instead of one job.
+
+    void* allocation;           // Heap block from Emitter_New, NULL for pooled or caller owned memory.
+    EmitterPool* pool;          // Pool to return to on Emitter_Free, if any.
+    Emitter* nextFree;          // Free list link while the slot sits unused in a pool.
+};
+
+// EmitterPool type.
+//----------------------------------------------------------------------------------
+
+// EmitterPool hands out fixed size emitter slots from one block, so effects can
+// create and destroy emitters without heap traffic.
+struct EmitterPool {
+    void* allocation;
+    size_t slotSize;
+    size_t particleCapacity;
+    int emitterCount;
+    Emitter* freeList;
 };
 
 // ParticleSystem type.
@@ -226,6 +292,9 @@ struct ParticleSystem {
     size_t capacity;
     Vector2 origin;
     Emitter** emitters;
+    JobSystem* jobs;            // Optional, see ParticleSystem_SetJobSystem.
+    Emitter** drawOrder;        // Scratch for ParticleSystem_Draw, same capacity as emitters.
+    int drawCalls;              // Issued by the last ParticleSystem_Draw.
 };
 
 #endif // LIBPARTIKEL_IMPLEMENTATION
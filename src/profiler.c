@@ -0,0 +1,357 @@
+#include "profiler.h"
+
+#if defined(SUPPORT_PROFILER)
+
+#include "threading.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#define PROFILER_OVERLAY_KEY KEY_F3
+#define PROFILER_OVERLAY_FONT_SIZE 10
+#define PROFILER_OVERLAY_LINE_HEIGHT 12
+#define PROFILER_OVERLAY_NAME_WIDTH 90
+#define PROFILER_OVERLAY_VALUE_WIDTH 50
+#define PROFILER_OVERLAY_COLUMNS 4 // zone name, avg, p99, max
+
+#define PROFILER_ZONE_NONE -1
+
+#if defined(_MSC_VER)
+	#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+	#define PROFILER_THREAD_LOCAL __thread
+#endif
+
+typedef struct TraceSlice {
+	const char* Name;
+	double Start;
+	double Duration;
+	const char* ArgNames[PROFILER_MAX_ARGS];
+	int Args[PROFILER_MAX_ARGS];
+	int8_t Zone; // PROFILER_ZONE_NONE for trace only slices
+	uint8_t ArgCount;
+} TraceSlice;
+
+// Only the owning thread writes to its buffer, so recording never takes a lock.
+// Registering a thread is a single atomic increment.
+typedef struct ProfilerThread {
+	char Name[32];
+	TraceSlice* Slices; // Ring of finished slices
+	uint32_t SliceCount; // Total finished, the ring keeps the last PROFILER_TRACE_CAPACITY
+	TraceSlice Open[PROFILER_MAX_DEPTH];
+	int Depth; // May go past PROFILER_MAX_DEPTH, those slices just aren't recorded
+} ProfilerThread;
+
+typedef struct Profiler {
+	ProfilerThread Threads[PROFILER_MAX_THREADS];
+	volatile int ThreadCount;
+
+	double Accumulated[PROFILE_ZONE_COUNT]; // Seconds spent in each zone so far this frame
+	float History[PROFILE_ZONE_COUNT][PROFILER_HISTORY]; // Milliseconds per frame
+	uint32_t FrameCount;
+	bool FrameOpen;
+	int ExportCount;
+
+	bool OverlayVisible;
+	char OverlayText[PROFILER_OVERLAY_COLUMNS][(PROFILE_ZONE_COUNT + 1) * 24]; // Has to live until the render queue is submitted
+} Profiler;
+
+static Profiler GlobalProfiler;
+
+static PROFILER_THREAD_LOCAL ProfilerThread* CurrentThread;
+static PROFILER_THREAD_LOCAL bool CurrentThreadRejected; // Came after PROFILER_MAX_THREADS, never recorded
+
+static const char* ZoneNames[PROFILE_ZONE_COUNT] = {
+	"frame",
+	"game_tick",
+	"draw_parallax",
+	"game_draw",
+	"ui_tick",
+	"ui_draw",
+	"submit",
+	"parse_level",
+	"asset_load",
+};
+
+static ProfilerThread* profiler_get_thread(void) {
+	if (CurrentThread == NULL && !CurrentThreadRejected) {
+		const int index = atomic_increment(&GlobalProfiler.ThreadCount) - 1;
+
+		if (index >= PROFILER_MAX_THREADS) {
+			CurrentThreadRejected = true;
+			return NULL;
+		}
+
+		ProfilerThread* thread = &GlobalProfiler.Threads[index];
+		thread->Slices = malloc(PROFILER_TRACE_CAPACITY * sizeof(TraceSlice));
+		snprintf(thread->Name, sizeof(thread->Name), "worker %d", index);
+
+		CurrentThread = thread;
+	}
+
+	return CurrentThread;
+}
+
+static void profiler_push(const char* name, int zone) {
+	ProfilerThread* thread = profiler_get_thread();
+	if (thread == NULL) return;
+
+	if (thread->Depth < PROFILER_MAX_DEPTH) {
+		TraceSlice* slice = &thread->Open[thread->Depth];
+		slice->Name = name;
+		slice->Zone = (int8_t)zone;
+		slice->ArgCount = 0;
+		slice->Start = thread_get_time();
+	}
+
+	thread->Depth += 1;
+}
+
+// Closes the innermost slice. The result stays valid until the next push on this thread.
+static TraceSlice* profiler_pop(void) {
+	ProfilerThread* thread = CurrentThread;
+	if (thread == NULL) return NULL;
+
+	assert(thread->Depth > 0);
+	thread->Depth -= 1;
+	if (thread->Depth >= PROFILER_MAX_DEPTH) return NULL;
+
+	TraceSlice* slice = &thread->Open[thread->Depth];
+	slice->Duration = thread_get_time() - slice->Start;
+
+	return slice;
+}
+
+static void profiler_record(const TraceSlice* slice) {
+	ProfilerThread* thread = CurrentThread;
+	if (thread->Slices == NULL) return;
+
+	thread->Slices[thread->SliceCount % PROFILER_TRACE_CAPACITY] = *slice;
+	thread->SliceCount += 1;
+}
+
+void profiler_begin(ProfileZone zone) {
+	assert(zone < PROFILE_ZONE_COUNT);
+	profiler_push(ZoneNames[zone], zone);
+}
+
+void profiler_end(ProfileZone zone) {
+	assert(zone < PROFILE_ZONE_COUNT);
+
+	TraceSlice* slice = profiler_pop();
+	if (slice == NULL) return;
+
+	assert(slice->Zone == (int8_t)zone); // Zones have to be closed in order
+	GlobalProfiler.Accumulated[zone] += slice->Duration;
+
+	if (zone == PROFILE_ZONE_FRAME && slice->Duration > PROFILER_LONG_FRAME) {
+		slice->Name = "long frame";
+	}
+
+	profiler_record(slice);
+}
+
+void profiler_slice_begin(const char* name) {
+	profiler_push(name, PROFILER_ZONE_NONE);
+}
+
+void profiler_slice_end(void) {
+	TraceSlice* slice = profiler_pop();
+	if (slice == NULL) return;
+
+	assert(slice->Zone == PROFILER_ZONE_NONE);
+	profiler_record(slice);
+}
+
+void profiler_slice_arg(const char* name, int value) {
+	ProfilerThread* thread = profiler_get_thread();
+	if (thread == NULL || thread->Depth == 0 || thread->Depth > PROFILER_MAX_DEPTH) return;
+
+	TraceSlice* slice = &thread->Open[thread->Depth - 1];
+	if (slice->ArgCount == PROFILER_MAX_ARGS) return;
+
+	slice->ArgNames[slice->ArgCount] = name;
+	slice->Args[slice->ArgCount] = value;
+	slice->ArgCount += 1;
+}
+
+void profiler_thread_name(const char* name) {
+	ProfilerThread* thread = profiler_get_thread();
+	if (thread == NULL) return;
+
+	snprintf(thread->Name, sizeof(thread->Name), "%s", name);
+}
+
+void profiler_frame_end(void) {
+	if (GlobalProfiler.FrameOpen) {
+		profiler_end(PROFILE_ZONE_FRAME);
+	}
+
+	const uint32_t slot = GlobalProfiler.FrameCount % PROFILER_HISTORY;
+	for (int i = 0; i < PROFILE_ZONE_COUNT; i++) {
+		GlobalProfiler.History[i][slot] = (float)(GlobalProfiler.Accumulated[i] * 1000.0);
+		GlobalProfiler.Accumulated[i] = 0.0;
+	}
+
+	GlobalProfiler.FrameCount += 1;
+
+	// The next frame is a slice of its own, everything the main thread does until the next call nests under it
+	profiler_begin(PROFILE_ZONE_FRAME);
+	profiler_slice_arg("frame", (int)GlobalProfiler.FrameCount);
+	GlobalProfiler.FrameOpen = true;
+}
+
+static void write_json_string(FILE* file, const char* text) {
+	fputc('"', file);
+
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') fputc('\\', file);
+		fputc(*c, file);
+	}
+
+	fputc('"', file);
+}
+
+bool profiler_export_trace(void) {
+	char fileName[32];
+	snprintf(fileName, sizeof(fileName), "trace_%03d.json", GlobalProfiler.ExportCount);
+
+	FILE* file = fopen(fileName, "w");
+	if (file == NULL) {
+		TraceLog(LOG_WARNING, "PROFILER: Failed to write trace [%s]", fileName);
+		return false;
+	}
+
+	GlobalProfiler.ExportCount += 1;
+
+	const int threadCount = GlobalProfiler.ThreadCount < PROFILER_MAX_THREADS ? GlobalProfiler.ThreadCount : PROFILER_MAX_THREADS;
+
+	// Timestamps are relative to the oldest slice that is still buffered
+	double epoch = thread_get_time();
+	for (int t = 0; t < threadCount; t++) {
+		const ProfilerThread* thread = &GlobalProfiler.Threads[t];
+		if (thread->Slices == NULL || thread->SliceCount == 0) continue;
+
+		const uint32_t count = thread->SliceCount < PROFILER_TRACE_CAPACITY ? thread->SliceCount : PROFILER_TRACE_CAPACITY;
+		for (uint32_t i = thread->SliceCount - count; i < thread->SliceCount; i++) {
+			const double start = thread->Slices[i % PROFILER_TRACE_CAPACITY].Start;
+			if (start < epoch) epoch = start;
+		}
+	}
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"raylib_game\"}}");
+
+	int sliceCount = 0;
+	for (int t = 0; t < threadCount; t++) {
+		const ProfilerThread* thread = &GlobalProfiler.Threads[t];
+
+		fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", t);
+		write_json_string(file, thread->Name);
+		fprintf(file, "}}");
+
+		if (thread->Slices == NULL) continue;
+
+		const uint32_t count = thread->SliceCount < PROFILER_TRACE_CAPACITY ? thread->SliceCount : PROFILER_TRACE_CAPACITY;
+		for (uint32_t i = thread->SliceCount - count; i < thread->SliceCount; i++) {
+			const TraceSlice* slice = &thread->Slices[i % PROFILER_TRACE_CAPACITY];
+			const char* category = slice->Zone == PROFILE_ZONE_FRAME ? "frame" : (slice->Zone == PROFILER_ZONE_NONE ? "slice" : "zone");
+
+			fprintf(file, ",\n{\"name\":");
+			write_json_string(file, slice->Name);
+			fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+				category, t, (slice->Start - epoch) * 1e6, slice->Duration * 1e6);
+
+			if (slice->ArgCount > 0) {
+				fprintf(file, ",\"args\":{");
+				for (int a = 0; a < slice->ArgCount; a++) {
+					if (a > 0) fputc(',', file);
+					write_json_string(file, slice->ArgNames[a]);
+					fprintf(file, ":%d", slice->Args[a]);
+				}
+				fputc('}', file);
+			}
+
+			fputc('}', file);
+			sliceCount += 1;
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	TraceLog(LOG_INFO, "PROFILER: Wrote %d slices from %d threads to [%s]", sliceCount, threadCount, fileName);
+
+	return true;
+}
+
+// Exports whatever is buffered, other threads have to be joined by now
+void profiler_exit(void) {
+	profiler_export_trace();
+
+	const int threadCount = GlobalProfiler.ThreadCount < PROFILER_MAX_THREADS ? GlobalProfiler.ThreadCount : PROFILER_MAX_THREADS;
+	for (int t = 0; t < threadCount; t++) {
+		free(GlobalProfiler.Threads[t].Slices);
+		GlobalProfiler.Threads[t].Slices = NULL;
+	}
+}
+
+static int compare_floats(const void* a, const void* b) {
+	const float fa = *(const float*)a;
+	const float fb = *(const float*)b;
+
+	return (fa > fb) - (fa < fb);
+}
+
+void profiler_draw_overlay(RenderQueue* renderQueue) {
+	if (IsKeyPressed(PROFILER_OVERLAY_KEY)) {
+		GlobalProfiler.OverlayVisible = !GlobalProfiler.OverlayVisible;
+	}
+
+	if (!GlobalProfiler.OverlayVisible) return;
+
+	const int frameCount = GlobalProfiler.FrameCount < PROFILER_HISTORY ? (int)GlobalProfiler.FrameCount : PROFILER_HISTORY;
+	if (frameCount == 0) return;
+
+	// The default font isn't monospaced, so every column is its own text
+	char* columns[PROFILER_OVERLAY_COLUMNS];
+	const char* columnEnds[PROFILER_OVERLAY_COLUMNS];
+	for (int c = 0; c < PROFILER_OVERLAY_COLUMNS; c++) {
+		columns[c] = GlobalProfiler.OverlayText[c];
+		columnEnds[c] = columns[c] + sizeof(GlobalProfiler.OverlayText[c]);
+	}
+
+	columns[0] += snprintf(columns[0], columnEnds[0] - columns[0], "ms, %d frames\n", frameCount);
+	columns[1] += snprintf(columns[1], columnEnds[1] - columns[1], "avg\n");
+	columns[2] += snprintf(columns[2], columnEnds[2] - columns[2], "p99\n");
+	columns[3] += snprintf(columns[3], columnEnds[3] - columns[3], "max\n");
+
+	float sorted[PROFILER_HISTORY];
+	for (int i = 0; i < PROFILE_ZONE_COUNT; i++) {
+		float sum = 0.0f;
+		for (int j = 0; j < frameCount; j++) {
+			sorted[j] = GlobalProfiler.History[i][j];
+			sum += sorted[j];
+		}
+
+		qsort(sorted, frameCount, sizeof(float), compare_floats);
+
+		const int p99Index = (frameCount * 99 + 99) / 100 - 1;
+		columns[0] += snprintf(columns[0], columnEnds[0] - columns[0], "%s\n", ZoneNames[i]);
+		columns[1] += snprintf(columns[1], columnEnds[1] - columns[1], "%.2f\n", sum / frameCount);
+		columns[2] += snprintf(columns[2], columnEnds[2] - columns[2], "%.2f\n", sorted[p99Index]);
+		columns[3] += snprintf(columns[3], columnEnds[3] - columns[3], "%.2f\n", sorted[frameCount - 1]);
+	}
+
+	const int lineCount = PROFILE_ZONE_COUNT + 1;
+	const int width = PROFILER_OVERLAY_NAME_WIDTH + (PROFILER_OVERLAY_COLUMNS - 1) * PROFILER_OVERLAY_VALUE_WIDTH;
+	render_queue_rect(renderQueue, RENDER_LAYER_OVERLAY, 4, 4, width + 8, lineCount * PROFILER_OVERLAY_LINE_HEIGHT + 8, 0);
+
+	for (int c = 0; c < PROFILER_OVERLAY_COLUMNS; c++) {
+		const int posX = c == 0 ? 8 : 8 + PROFILER_OVERLAY_NAME_WIDTH + (c - 1) * PROFILER_OVERLAY_VALUE_WIDTH;
+		render_queue_text(renderQueue, RENDER_LAYER_OVERLAY, GlobalProfiler.OverlayText[c], posX, 8, PROFILER_OVERLAY_FONT_SIZE, PROFILER_OVERLAY_LINE_HEIGHT, RENDER_COLOR_WHITE);
+	}
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "render_queue.h"
+
+// Scoped zone timers for debug builds. Every zone adds up its time over a frame, profiler_frame_end
+// stores the totals in a ring of the last PROFILER_HISTORY frames and the overlay (F3) shows the
+// rolling average, p99 and max per zone.
+// Zones and named slices also go into a per thread trace buffer, profiler_export_trace writes those
+// as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev). Every frame is a slice on the main
+// thread, so the zones of a stutter show up nested under its "long frame".
+// Define SUPPORT_PROFILER to get it in a release build, otherwise the macros compile to nothing.
+#if defined(_DEBUG) && !defined(SUPPORT_PROFILER)
+	#define SUPPORT_PROFILER
+#endif
+
+#define PROFILER_HISTORY 240
+#define PROFILER_TRACE_CAPACITY 16384 // Finished slices kept per thread, the oldest get overwritten
+#define PROFILER_MAX_THREADS 80
+#define PROFILER_MAX_DEPTH 16
+#define PROFILER_MAX_ARGS 3
+#define PROFILER_LONG_FRAME (1.5 / 60.0) // Frames slower than this are named "long frame" in the trace
+
+// A zone is only ever timed by one thread at a time.
+// PROFILE_ZONE_GAME_TICK runs on the sim thread, profiler_frame_end must come after sim_thread_join.
+typedef enum ProfileZone {
+	PROFILE_ZONE_FRAME = 0, // Time between two profiler_frame_end calls, filled in by the profiler
+	PROFILE_ZONE_GAME_TICK,
+	PROFILE_ZONE_DRAW_PARALLAX,
+	PROFILE_ZONE_GAME_DRAW,
+	PROFILE_ZONE_UI_TICK,
+	PROFILE_ZONE_UI_DRAW,
+	PROFILE_ZONE_SUBMIT,
+	PROFILE_ZONE_PARSE_LEVEL,
+	PROFILE_ZONE_ASSET_LOAD,
+	PROFILE_ZONE_COUNT
+} ProfileZone;
+
+#if defined(SUPPORT_PROFILER)
+	#define PROFILE_BEGIN(zone) profiler_begin(zone)
+	#define PROFILE_END(zone) profiler_end(zone)
+	#define PROFILE_SLICE_BEGIN(name) profiler_slice_begin(name)
+	#define PROFILE_SLICE_END() profiler_slice_end()
+	#define PROFILE_SLICE_ARG(name, value) profiler_slice_arg(name, value)
+	#define PROFILE_THREAD_NAME(name) profiler_thread_name(name)
+	#define PROFILE_FRAME_END() profiler_frame_end()
+	#define PROFILE_DRAW_OVERLAY(renderQueue) profiler_draw_overlay(renderQueue)
+	#define PROFILE_EXPORT_TRACE() profiler_export_trace()
+	#define PROFILE_EXIT() profiler_exit()
+
+void profiler_begin(ProfileZone zone);
+void profiler_end(ProfileZone zone);
+
+// Trace only slices. name has to outlive the profiler, string literals or asset paths.
+void profiler_slice_begin(const char* name);
+void profiler_slice_end(void);
+void profiler_slice_arg(const char* name, int value); // Attaches to the innermost open slice of this thread
+
+void profiler_thread_name(const char* name);
+void profiler_frame_end(void);
+void profiler_draw_overlay(RenderQueue* renderQueue);
+
+// Writes trace_NNN.json. Reads every thread's buffer, so only call it while the other threads are idle.
+bool profiler_export_trace(void);
+void profiler_exit(void);
+#else
+	#define PROFILE_BEGIN(zone) ((void)0)
+	#define PROFILE_END(zone) ((void)0)
+	#define PROFILE_SLICE_BEGIN(name) ((void)0)
+	#define PROFILE_SLICE_END() ((void)0)
+	#define PROFILE_SLICE_ARG(name, value) ((void)0)
+	#define PROFILE_THREAD_NAME(name) ((void)0)
+	#define PROFILE_FRAME_END() ((void)0)
+	#define PROFILE_DRAW_OVERLAY(renderQueue) ((void)0)
+	#define PROFILE_EXPORT_TRACE() ((void)0)
+	#define PROFILE_EXIT() ((void)0)
+#endif
+
+#endif
@@ -39,10 +39,20 @@
 #include "level_parser.h"
 #include "UISystem.h"
 #include "image_color_parser.h"
+#include "parallax.h"
+#include "render_queue.h"
+#include "sim_thread.h"
+#include "asset_loader.h"
+#include "job_system.h"
+#include "threading.h"
+#include "profiler.h"
 
 void app_loop(void);
 void draw_parallax(void);
 void go_to_next_level(void);
+void update_render_scale(void);
+void begin_frame(uint8_t clearColorIndex);
+void end_frame(void);
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
@@ -56,6 +66,11 @@ void go_to_next_level(void);
     #define LOG(...)
 #endif
 
+// Render everything into a fixed screenWidth x screenHeight target and upscale it to the window
+// with the biggest integer nearest-neighbour scale that fits. Fill cost no longer depends on the
+// window size and the pixel art stays crisp at 1440p/4K.
+#define SUPPORT_RENDER_TARGET
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
@@ -85,6 +100,7 @@ static const uint16_t screenWidth = 800;
 static const uint16_t screenHeight = 450;
 
 #define STARTING_LEVEL 1
+#define ASSET_PACK_PATH "resources.pak"
 #define MAX_LEVELS 3
 
 static Color gameColors[8];
@@ -119,14 +135,23 @@ static LevelData* levelData = NULL;
 static float slowMoMultiplier = 1.0f;
 #endif
 
-static Texture2D CavePar1;
-static Texture2D CavePar2;
-static Texture2D CavePar3;
- 
-static Texture2D WoodsPar1;
-static Texture2D WoodsPar2;
+static ParallaxBand WoodsParallax;
+static ParallaxBand CaveParallax;
+
+static Music MainTheme;
+static AssetFile MainThemeFile; // Streamed from while playing
+
+// The *_draw functions only record into this queue, it gets sorted and sent to raylib in end_frame
+static RenderQueue FrameRenderQueue;
 
-static Sound MainTheme;
+static SimThread GameSimThread;
+
+#if defined(SUPPORT_RENDER_TARGET)
+static RenderTexture2D RenderTarget;
+static int RenderScale = 1;
+static int RenderOffsetX = 0;
+static int RenderOffsetY = 0;
+#endif
 
 void OnPlayButtonClicked(void* context) {
     (void)context; 
@@ -197,17 +222,44 @@ int main(void)
 #else
     SetTraceLogLevel(LOG_ALL);         
 #endif
+
+    PROFILE_THREAD_NAME("main");
  
     // Initialization
     //--------------------------------------------------------------------------------------
+#if defined(SUPPORT_RENDER_TARGET)
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+#endif
     InitWindow(screenWidth, screenHeight, "Korneel Guns: Tethered (RayJam 2024)");
     InitAudioDevice();
+
+#if defined(SUPPORT_RENDER_TARGET)
+    SetWindowMinSize(screenWidth, screenHeight);
+
+    RenderTarget = LoadRenderTexture(screenWidth, screenHeight);
+    SetTextureFilter(RenderTarget.texture, TEXTURE_FILTER_POINT);
+#endif
+
+    // Startup timer: window and audio device are up, measure everything from here to the first frame
+    const double startupTime = thread_get_time();
+    PROFILE_SLICE_BEGIN("startup");
+
+    // Everything under resources/ in one mapped file, written by the pack_assets tool. Loose files are used without it.
+    // Desktop only: the web build preloads resources/ into its file system, the pack sits outside of it.
+#if !defined(PLATFORM_WEB)
+    asset_pack_mount(ASSET_PACK_PATH);
+#endif
+
+    // Images are only queued during initialization, see the asset loading below
+    AssetLoader assetLoader = { 0 };
+    assetLoader.CacheDirectory = "resources/cooked"; // Cooked on the first run, ship the blobs to skip conversion entirely
+    AssetImage bladeSawAsset = { .Path = "resources/images/bladesaw.png", .Palette = gameColors, .ColorCount = 8, .Indexed = true };
     
     // Data/Resource initialization scope
     {
         // Load palette
         {
-            Image temp = LoadImage("resources/palettes/custodian.png");
+            Image temp = asset_image_load("resources/palettes/custodian.png");
             assert(temp.data != NULL);
             if (temp.data != NULL) {
                 int count = temp.width;
@@ -222,19 +274,14 @@ int main(void)
                 UnloadImage(temp);
             }
 
-            BladeSaw = LoadTexture("resources/images/bladesaw.png");
+            // Built up front, the loader threads only read it
+            prepare_palette_lut(gameColors, 8);
 
-            CavePar1 = load_and_convert_texture("resources/images/parallax/cave/2.png", gameColors, 8);
-            CavePar2 = load_and_convert_texture("resources/images/parallax/cave/4.png", gameColors, 8);
-            CavePar3 = load_and_convert_texture("resources/images/parallax/cave/7.png", gameColors, 8);
-            SetTextureWrap(CavePar1, TEXTURE_WRAP_REPEAT);
-            SetTextureWrap(CavePar2, TEXTURE_WRAP_REPEAT);
-            SetTextureWrap(CavePar3, TEXTURE_WRAP_REPEAT);
+            render_queue_init(&FrameRenderQueue, gameColors, 8);
 
-            WoodsPar1 = load_and_convert_texture("resources/images/parallax/demon-woods/far.png", gameColors, 8);
-            WoodsPar2 = load_and_convert_texture("resources/images/parallax/demon-woods/close.png", gameColors, 8);   
-            SetTextureWrap(WoodsPar1, TEXTURE_WRAP_REPEAT);
-            SetTextureWrap(WoodsPar2, TEXTURE_WRAP_REPEAT);
+            asset_loader_add_image(&assetLoader, &bladeSawAsset);
+
+            parallax_create_game_bands(&WoodsParallax, &CaveParallax, &assetLoader, screenWidth, screenHeight, gameColors, 8);
         }
 
         const uint16_t buttonWidth = 180;
@@ -278,14 +325,43 @@ int main(void)
         ui_add_rectangle_with_text(UIDataGameVictory, screenWidth / 2 - 300, screenHeight / 2 - 155, 600, 260, 4, "You did it! You did it!\n\nThat was sick! This definitely gives you bragging rights!\n\n..mm what? Yes, you also united them.\nGood job on that too, I suppose.\n..yes, they also lived happily ever after.\nPlease stop asking questions now.", UIStyleTextInGameVictory);
         ui_add_button(UIDataGameVictory, screenWidth / 2 - buttonWidth / 2, screenHeight - 110, buttonWidth, buttonHeight, "back", UIStyleButtonGame, OnInGameVictoryButtonClicked, NULL, true);
 
-        MainTheme = LoadSound("resources/music/relax_and_chill.mp3");
+        MainTheme = asset_music_load("resources/music/relax_and_chill.mp3", &MainThemeFile);
+        MainTheme.looping = true;
     }
     
+    PROFILE_SLICE_BEGIN("load_level");
     parse_level("resources/levels/level_1.txt", levelData); // Preload
-    game_create(gameData, levelData, gameColors, screenWidth, screenHeight);
+    game_create(gameData, levelData, gameColors, screenWidth, screenHeight, &assetLoader);
+    PROFILE_SLICE_ARG("level", 1);
+    PROFILE_SLICE_ARG("width", levelData->LevelWidth);
+    PROFILE_SLICE_ARG("enemies", gameData->EnemyCount);
+    PROFILE_SLICE_END();
+
+    // Decode and convert all queued images in parallel, then upload them in one batch on the main thread (it owns the GL context)
+    {
+        JobSystem* loadJobs = job_system_create(thread_get_cpu_count());
+        asset_loader_run(&assetLoader, loadJobs);
+        job_system_destroy(loadJobs);
+
+        PROFILE_SLICE_BEGIN("gpu_upload");
+        BladeSaw = LoadTextureFromImage(bladeSawAsset.Image);
+        UnloadImage(bladeSawAsset.Image);
+
+        parallax_band_bake(&WoodsParallax);
+        parallax_band_bake(&CaveParallax);
+        game_upload_textures(gameData, gameColors);
+        PROFILE_SLICE_END();
+    }
+
     game_menu_init(gameData, screenWidth, screenHeight);
 
-    PlaySound(MainTheme);
+    sim_thread_init(&GameSimThread);
+
+    PlayMusicStream(MainTheme);
+
+    PROFILE_SLICE_END();
+
+    LOG("Startup: %.1f ms, of which %.1f ms decoding and converting images\n", (thread_get_time() - startupTime) * 1000.0, assetLoader.LoadTime * 1000.0);
 
     //--------------------------------------------------------------------------------------
 #if defined(PLATFORM_WEB)
@@ -301,14 +377,21 @@ int main(void)
 #endif
     //--------------------------------------------------------------------------------------
   
+#if defined(SUPPORT_RENDER_TARGET)
+    UnloadRenderTexture(RenderTarget);
+#endif
+
+    sim_thread_exit(&GameSimThread);
+    render_queue_exit(&FrameRenderQueue);
+
+    PROFILE_EXIT(); // Writes the trace, after the sim thread is gone
+
     UnloadTexture(BladeSaw);
-    UnloadTexture(CavePar1);
-    UnloadTexture(CavePar2);
-    UnloadTexture(CavePar3);
-    UnloadTexture(WoodsPar1);
-    UnloadTexture(WoodsPar2);
+    parallax_band_exit(&WoodsParallax);
+    parallax_band_exit(&CaveParallax);
 
-    UnloadSound(MainTheme);
+    UnloadMusicStream(MainTheme);
+    asset_file_close(&MainThemeFile);
 
     game_exit(gameData);
     ui_exit(UIDataGame);
@@ -327,6 +410,8 @@ int main(void)
     RL_FREE(UIDataMenuCredits);
     RL_FREE(UIDataGameVictory);
 
+    asset_pack_unmount();
+
     CloseAudioDevice();
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
@@ -350,6 +435,23 @@ void app_loop(void) {
     dt *= slowMoMultiplier;
 #endif
 
+    // Wait for the tick kicked last frame, after this gameData belongs to the main thread again
+    sim_thread_join(&GameSimThread);
+
+    PROFILE_FRAME_END();
+    PROFILE_SLICE_ARG("level", CurrentLevel);
+    PROFILE_SLICE_ARG("enemies", gameData->EnemyCount);
+#if defined(SUPPORT_PROFILER)
+    // Only the main thread is busy right now, which is what the export needs
+    if (IsKeyPressed(KEY_F4)) {
+        profiler_export_trace();
+    }
+#endif
+
+    game_play_sounds(gameData);
+
+    update_render_scale();
+
     switch (CurrentState) {
     case SCREEN_LOGO:
         break;
@@ -359,27 +461,24 @@ void app_loop(void) {
         game_menu_tick(gameData, screenWidth, screenHeight, dt);
         ui_tick(UIDataMenu);
 
-        BeginDrawing();
-        ClearBackground(gameColors[4]);
-        ui_draw(UIDataMenu, gameColors);
-        game_menu_draw(gameData, gameColors);
-        EndDrawing();
+        begin_frame(4);
+        ui_draw(UIDataMenu, &FrameRenderQueue, RENDER_LAYER_MENU_UI);
+        game_menu_draw(gameData, &FrameRenderQueue);
+        end_frame();
     } break;
     case SCREEN_MENU_INSTRUCTIONS: {
         ui_tick(UIDataMenuInstructions); 
 
-        BeginDrawing();
-        ClearBackground(gameColors[4]);
-        ui_draw(UIDataMenuInstructions, gameColors);
-        EndDrawing();
+        begin_frame(4);
+        ui_draw(UIDataMenuInstructions, &FrameRenderQueue, RENDER_LAYER_UI);
+        end_frame();
     } break;
     case SCREEN_MENU_CREDITS:{
         ui_tick(UIDataMenuCredits);
 
-        BeginDrawing();
-        ClearBackground(gameColors[4]);
-        ui_draw(UIDataMenuCredits, gameColors);
-        EndDrawing();
+        begin_frame(4);
+        ui_draw(UIDataMenuCredits, &FrameRenderQueue, RENDER_LAYER_UI);
+        end_frame();
     } break;
     case SCREEN_GAMEPLAY_INTRO: {
         switch (IntroSubState) {
@@ -400,23 +499,22 @@ void app_loop(void) {
 
         ui_tick(UIDataGameIntro);
 
-        BeginDrawing();
-        ClearBackground(gameColors[5]);
+        begin_frame(5);
 
         draw_parallax();
-        game_draw(gameData, levelData, gameColors);
+        game_draw(gameData, levelData, &FrameRenderQueue, screenWidth, screenHeight);
 
         if (IntroSubState == INTRO_SLIDE_2 && CurrentStateTimer > 0.5f) {
-            game_bladesaws_draw(gameData, BladeSaw, dt); 
+            game_bladesaws_draw(gameData, &FrameRenderQueue, BladeSaw, dt); 
         }
 
-        ui_draw(UIDataGameIntro, gameColors); 
+        ui_draw(UIDataGameIntro, &FrameRenderQueue, RENDER_LAYER_UI); 
 
         if (DoIntroSlide && CurrentStateTimer < 0.5f) {
-            DrawRectangle(CurrentStateTimer * screenWidth * 2.3f, 0, screenWidth, screenHeight, gameColors[0]);
+            render_queue_rect(&FrameRenderQueue, RENDER_LAYER_OVERLAY, CurrentStateTimer * screenWidth * 2.3f, 0, screenWidth, screenHeight, 0);
         }
 
-        EndDrawing();
+        end_frame();
 
     } break;
     case SCREEN_GAMEPLAY: {
@@ -426,26 +524,21 @@ void app_loop(void) {
         }
 #endif
 
-        if (CurrentStateTimer > 0.5f) {
-            game_tick(gameData, levelData, screenWidth, screenHeight, dt);
-        }
-
         ui_tick(UIDataGame);
 
-        BeginDrawing();
-        ClearBackground(gameColors[5]);
+        // Draws the result of the tick that ran during the previous frame
+        begin_frame(5);
 
         draw_parallax();
-        game_draw(gameData, levelData, gameColors); 
-        game_bladesaws_draw(gameData, BladeSaw, dt);
-        ui_draw(UIDataGame, gameColors);
+        game_draw(gameData, levelData, &FrameRenderQueue, screenWidth, screenHeight); 
+        game_bladesaws_draw(gameData, &FrameRenderQueue, BladeSaw, dt);
+        ui_draw(UIDataGame, &FrameRenderQueue, RENDER_LAYER_UI);
 
         if (DoIntroSlide && CurrentStateTimer < 0.5f) {
-            DrawRectangle(CurrentStateTimer * screenWidth * 2.3f, 0, screenWidth, screenHeight, gameColors[0]);
+            render_queue_rect(&FrameRenderQueue, RENDER_LAYER_OVERLAY, CurrentStateTimer * screenWidth * 2.3f, 0, screenWidth, screenHeight, 0);
         }
 
         //DrawFPS(10, 10);
-        EndDrawing();
 
         if (gameData->NextLevel) {
             CurrentState = SCREEN_GAMEPLAY_LEVEL_TRANSITION;
@@ -455,24 +548,26 @@ void app_loop(void) {
         if (gameData->RestartLevel) {
             gameData->RestartLevel = false;
 
-            PlaySound(gameData->Respawn);
+            sound_event_push(&gameData->SoundEvents, GAME_SOUND_RESPAWN);
 
             CurrentStateTimer = 0.0f;
 
             game_restart(gameData, levelData);
         }
 
+        // The next tick runs on the sim thread while this frame's commands get submitted
+        if (CurrentState == SCREEN_GAMEPLAY && CurrentStateTimer > 0.5f) {
+            sim_thread_kick(&GameSimThread, gameData, levelData, game_read_input(), screenWidth, screenHeight, dt);
+        }
+
+        end_frame();
     } break;
     case SCREEN_GAMEPLAY_LEVEL_TRANSITION: {
-        game_tick(gameData, levelData, screenWidth, screenHeight, dt);
-
-        BeginDrawing();
-        ClearBackground(gameColors[5]);
+        begin_frame(5);
         draw_parallax();
-        game_draw(gameData, levelData, gameColors);
-        DrawRectangle(0, 0, CurrentStateTimer * screenWidth * 1.8f, screenHeight, gameColors[0]);
+        game_draw(gameData, levelData, &FrameRenderQueue, screenWidth, screenHeight);
+        render_queue_rect(&FrameRenderQueue, RENDER_LAYER_OVERLAY, 0, 0, CurrentStateTimer * screenWidth * 1.8f, screenHeight, 0);
         //DrawFPS(10, 10);
-        EndDrawing();
 
         if (CurrentStateTimer > 1.2f) {
             CurrentState = SCREEN_GAMEPLAY;
@@ -482,15 +577,18 @@ void app_loop(void) {
 
             go_to_next_level();
         }
+        else {
+            sim_thread_kick(&GameSimThread, gameData, levelData, game_read_input(), screenWidth, screenHeight, dt);
+        }
 
+        end_frame();
     } break;
     case SCREEN_GAMEPLAY_VICTORY: {
         ui_tick(UIDataGameVictory);
 
-        BeginDrawing();
-        ClearBackground(gameColors[0]);
-        ui_draw(UIDataGameVictory, gameColors);
-        EndDrawing();
+        begin_frame(0);
+        ui_draw(UIDataGameVictory, &FrameRenderQueue, RENDER_LAYER_UI);
+        end_frame();
     } break;
     default:
         assert(false); // Should probably implement this state
@@ -499,36 +597,70 @@ void app_loop(void) {
 
     CurrentStateTimer += dt;
 
-    if (!IsSoundPlaying(MainTheme)) {
-        PlaySound(MainTheme);
-    }
+    // Refills the stream buffers, the stream loops on its own
+    UpdateMusicStream(MainTheme);
 }
 
 void draw_parallax(void) { 
-    {
-        // aspect ratio is ~4.35
-        Rectangle dest = (Rectangle){ 0, 0, screenWidth, screenHeight / 2 };
+    PROFILE_BEGIN(PROFILE_ZONE_DRAW_PARALLAX);
+    parallax_band_draw(&WoodsParallax, &FrameRenderQueue, gameData->CameraPosX);
+    parallax_band_draw(&CaveParallax, &FrameRenderQueue, gameData->CameraPosX);
+    PROFILE_END(PROFILE_ZONE_DRAW_PARALLAX);
+}
 
-        Rectangle source1 = (Rectangle){ gameData->CameraPosX * 0.1f, 60, 230 * 4.35f, 180 };
-        DrawTexturePro(WoodsPar1, source1, dest, (Vector2) { 0, 0 }, 0.0f, WHITE);
+void update_render_scale(void) {
+#if defined(SUPPORT_RENDER_TARGET)
+    int scaleX = GetScreenWidth() / screenWidth;
+    int scaleY = GetScreenHeight() / screenHeight;
 
-        Rectangle source2 = (Rectangle){ gameData->CameraPosX * 0.3f, 60, 230 * 4.35f, 180 };
-        DrawTexturePro(WoodsPar2, source2, dest, (Vector2) { 0, 0 }, 0.0f, WHITE);
-    }
+    RenderScale = scaleX < scaleY ? scaleX : scaleY;
+    if (RenderScale < 1) RenderScale = 1;
 
-    {
-        // aspect ratio is ~3.56
-        Rectangle dest = (Rectangle){ 0, screenHeight / 2, screenWidth, screenHeight / 2 };
+    RenderOffsetX = (GetScreenWidth() - screenWidth * RenderScale) / 2;
+    RenderOffsetY = (GetScreenHeight() - screenHeight * RenderScale) / 2;
 
-        Rectangle source1 = (Rectangle){ gameData->CameraPosX * 0.05f, 30, 1080 * 3.556f, 1080 };
-        DrawTexturePro(CavePar1, source1, dest, (Vector2) { 0, 0 }, 0.0f, WHITE);
+    // The UI hit-tests in render target coordinates
+    SetMouseOffset(-RenderOffsetX, -RenderOffsetY);
+    SetMouseScale(1.0f / RenderScale, 1.0f / RenderScale);
+#endif
+}
+
+void begin_frame(uint8_t clearColorIndex) {
+    render_queue_begin(&FrameRenderQueue, clearColorIndex);
+}
+
+void end_frame(void) {
+    PROFILE_DRAW_OVERLAY(&FrameRenderQueue);
+
+#if defined(SUPPORT_RENDER_TARGET)
+    BeginTextureMode(RenderTarget);
+    PROFILE_BEGIN(PROFILE_ZONE_SUBMIT);
+    render_queue_submit(&FrameRenderQueue);
+    PROFILE_END(PROFILE_ZONE_SUBMIT);
+    EndTextureMode();
+
+    BeginDrawing();
+    ClearBackground(BLACK);
 
-        Rectangle source2 = (Rectangle){ gameData->CameraPosX * 0.25f, 120, 830 * 3.556f, 830 };
-        DrawTexturePro(CavePar2, source2, dest, (Vector2) { 0, 0 }, 0.0f, WHITE); 
+    // Render textures are stored upside down, hence the negative source height
+    Rectangle source = (Rectangle){ 0, 0, screenWidth, -screenHeight };
+    Rectangle dest = (Rectangle){ RenderOffsetX, RenderOffsetY, screenWidth * RenderScale, screenHeight * RenderScale };
+    DrawTexturePro(RenderTarget.texture, source, dest, (Vector2) { 0, 0 }, 0.0f, WHITE);
 
-        Rectangle source3 = (Rectangle){ gameData->CameraPosX * 0.9f, 70, 900 * 3.556f, 900 };
-        DrawTexturePro(CavePar3, source3, dest, (Vector2) { 0, 0 }, 0.0f, WHITE); 
+    EndDrawing();
+#else
+    BeginDrawing();
+    PROFILE_BEGIN(PROFILE_ZONE_SUBMIT);
+    render_queue_submit(&FrameRenderQueue);
+    PROFILE_END(PROFILE_ZONE_SUBMIT);
+    EndDrawing();
+#endif
+
+#if defined(_DEBUG)
+    if (IsKeyPressed(KEY_F9)) {
+        render_queue_save_capture(&FrameRenderQueue, "frame_capture.txt");
     }
+#endif
 }
 
 void go_to_next_level(void) {
@@ -541,6 +673,8 @@ void go_to_next_level(void) {
         return;
     }
 
+    PROFILE_SLICE_BEGIN("load_level");
+
     switch(CurrentLevel) {
     case 1:
         assert(levelData != NULL);
@@ -554,5 +688,11 @@ void go_to_next_level(void) {
         break;
     }
     
-    game_restart(gameData, levelData);
+    // Main thread, after the sim join: picks the sheets for this level's tile size from the sprite cache
+    game_init(gameData, levelData, gameColors, screenWidth, screenHeight);
+
+    PROFILE_SLICE_ARG("level", CurrentLevel);
+    PROFILE_SLICE_ARG("width", levelData->LevelWidth);
+    PROFILE_SLICE_ARG("enemies", gameData->EnemyCount);
+    PROFILE_SLICE_END();
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include "render_queue.h"
+
+#include "particles.h"
+#include "rlgl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define DEFAULT_TEXT_LINE_SPACING 15
+
+// Indexed sprites store a palette index per texel in the red channel (grayscale textures).
+// The default vertex shader is used, this only swaps the index for its palette colour.
+#if defined(PLATFORM_WEB)
+static const char* PaletteFragmentShader =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "varying vec2 fragTexCoord;\n"
+    "varying vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform sampler2D palette;\n"
+    "uniform vec4 colDiffuse;\n"
+    "void main() {\n"
+    "    float index = texture2D(texture0, fragTexCoord).r * 255.0;\n"
+    "    gl_FragColor = texture2D(palette, vec2((index + 0.5) / 256.0, 0.5)) * colDiffuse * fragColor;\n"
+    "}\n";
+#else
+static const char* PaletteFragmentShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "in vec4 fragColor;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform sampler2D palette;\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() {\n"
+    "    float index = texture(texture0, fragTexCoord).r * 255.0;\n"
+    "    finalColor = texture(palette, vec2((index + 0.5) / 256.0, 0.5)) * colDiffuse * fragColor;\n"
+    "}\n";
+#endif
+
+static int compare_sort_keys(const void* a, const void* b) {
+    uint64_t keyA = *(const uint64_t*)a;
+    uint64_t keyB = *(const uint64_t*)b;
+
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+// The low 32 bits hold the command index, which keeps the sort stable and lets submit find the command back
+static uint64_t make_sort_key(const RenderCommand* command, uint32_t index) {
+    return ((uint64_t)command->Layer << 56) | ((uint64_t)(command->Blend & 0xF) << 52) | ((uint64_t)command->TextureIndex << 44) | index;
+}
+
+// Returns 0 when a frame uses more than MAX_RENDER_TEXTURES textures, the caller drops its command then
+static uint8_t texture_index(RenderQueue* queue, Texture2D texture) {
+    for (uint8_t i = 0; i < queue->TextureCount; i++) {
+        if (queue->Textures[i].id == texture.id) return i + 1;
+    }
+
+    if (queue->TextureCount >= MAX_RENDER_TEXTURES) {
+        static bool warned = false;
+        if (!warned) TraceLog(LOG_WARNING, "RENDER: More than %i textures in a frame, draws with texture %u are dropped", MAX_RENDER_TEXTURES, texture.id);
+        warned = true;
+
+        assert(false);
+        return 0;
+    }
+
+    queue->Textures[queue->TextureCount] = texture;
+    queue->TextureCount += 1;
+
+    return queue->TextureCount;
+}
+
+static RenderCommand* push_command(RenderQueue* queue, uint8_t type, uint8_t layer) {
+    if (queue->CommandCount >= queue->CommandCapacity) {
+        uint32_t newCapacity = queue->CommandCapacity * 2;
+
+        queue->Commands = RL_REALLOC(queue->Commands, newCapacity * sizeof(RenderCommand));
+        queue->SortKeys = RL_REALLOC(queue->SortKeys, newCapacity * sizeof(uint64_t));
+        queue->CommandCapacity = newCapacity;
+    }
+
+    RenderCommand* command = &queue->Commands[queue->CommandCount];
+    memset(command, 0, sizeof(RenderCommand));
+    command->Type = type;
+    command->Layer = layer;
+    command->Blend = queue->CurrentBlend;
+
+    queue->CommandCount += 1;
+
+    return command;
+}
+
+void render_queue_init(RenderQueue* queue, Color* palette, uint8_t paletteSize) {
+    memset(queue, 0, sizeof(RenderQueue));
+
+    queue->CommandCapacity = 1024;
+    queue->Commands = RL_MALLOC(queue->CommandCapacity * sizeof(RenderCommand));
+    queue->SortKeys = RL_MALLOC(queue->CommandCapacity * sizeof(uint64_t));
+    queue->QuadCapacity = 1024;
+    queue->QuadPositions = RL_MALLOC(queue->QuadCapacity * sizeof(Vector2));
+    queue->QuadSizes = RL_MALLOC(queue->QuadCapacity * sizeof(float));
+    queue->PaletteSize = paletteSize;
+
+    Image paletteImage = GenImageColor(RENDER_PALETTE_SIZE, 1, BLANK);
+    queue->PaletteTexture = LoadTextureFromImage(paletteImage);
+    UnloadImage(paletteImage);
+
+    queue->PaletteShader = LoadShaderFromMemory(NULL, PaletteFragmentShader);
+    queue->PaletteTextureLocation = GetShaderLocation(queue->PaletteShader, "palette");
+
+    render_queue_set_palette(queue, palette);
+
+#if defined(SUPPORT_RENDER_STATS)
+    batch_counter_init(&queue->StatsCounter);
+#endif
+}
+
+void render_queue_exit(RenderQueue* queue) {
+    RL_FREE(queue->Commands);
+    RL_FREE(queue->SortKeys);
+    RL_FREE(queue->QuadPositions);
+    RL_FREE(queue->QuadSizes);
+
+    UnloadTexture(queue->PaletteTexture);
+    UnloadShader(queue->PaletteShader);
+
+#if defined(SUPPORT_RENDER_STATS)
+    batch_counter_exit(&queue->StatsCounter);
+#endif
+
+    queue->Commands = NULL;
+    queue->SortKeys = NULL;
+    queue->QuadPositions = NULL;
+    queue->QuadSizes = NULL;
+    queue->QuadCount = 0;
+    queue->QuadCapacity = 0;
+    queue->CommandCount = 0;
+    queue->CommandCapacity = 0;
+}
+
+void render_queue_begin(RenderQueue* queue, uint8_t clearColorIndex) {
+    queue->CommandCount = 0;
+    queue->QuadCount = 0;
+    queue->TextureCount = 0;
+    queue->ClearColorIndex = clearColorIndex;
+    queue->CurrentBlend = BLEND_ALPHA;
+}
+
+#if defined(SUPPORT_RENDER_STATS)
+static void stats_begin(RenderQueue* queue) {
+    memset(&queue->Stats, 0, sizeof(RenderStats));
+    queue->Stats.Commands = queue->CommandCount;
+
+    batch_counter_begin(&queue->StatsCounter);
+}
+
+static void stats_end(RenderQueue* queue) {
+    batch_counter_end(&queue->StatsCounter);
+
+    queue->Stats.DrawCalls = queue->StatsCounter.DrawCalls;
+    queue->Stats.TextureBinds = queue->StatsCounter.TextureBinds;
+    queue->Stats.BatchFlushes = queue->StatsCounter.BatchFlushes;
+}
+
+// DrawText would flush wherever the batch runs out, the draw it opened for the font would go out unseen.
+// Flushing before it, for four vertices per non-blank byte, leaves only that flush to sample.
+static void reserve_text(RenderQueue* queue, const char* text) {
+    int glyphs = 0;
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c != ' ' && *c != '\t' && *c != '\n') glyphs += 1;
+    }
+
+    rlCheckRenderBatchLimit(glyphs * 4);
+    batch_counter_sample(&queue->StatsCounter);
+}
+
+    #define STATS_SAMPLE(queue) batch_counter_sample(&(queue)->StatsCounter)
+    #define STATS_COUNT(queue, counter, amount) ((queue)->Stats.counter += (amount))
+#else
+    #define STATS_SAMPLE(queue) ((void)0)
+    #define STATS_COUNT(queue, counter, amount) ((void)0)
+#endif
+
+// Writes solid quads straight into the rlgl batch with the particle quad writer
+static void draw_quads(RenderQueue* queue, const RenderCommand* command, Color color) {
+    rlSetTexture(rlGetTextureIdDefault());
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+
+#if defined(SUPPORT_RENDER_STATS)
+    // One chunk at a time, a single Particles_WriteQuads may flush more than once
+    for (uint32_t first = 0; first < command->QuadCount; first += PARTICLE_DRAW_CHUNK) {
+        const uint32_t remaining = command->QuadCount - first;
+        const uint32_t count = remaining < PARTICLE_DRAW_CHUNK ? remaining : PARTICLE_DRAW_CHUNK;
+
+        Particles_WriteQuads(queue->QuadPositions + command->FirstQuad + first, queue->QuadSizes + command->FirstQuad + first, count, false);
+        batch_counter_sample(&queue->StatsCounter);
+    }
+#else
+    Particles_WriteQuads(queue->QuadPositions + command->FirstQuad, queue->QuadSizes + command->FirstQuad, command->QuadCount, false);
+#endif
+
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void render_queue_submit(RenderQueue* queue) {
+    ClearBackground(queue->Palette[queue->ClearColorIndex]);
+
+#if defined(SUPPORT_RENDER_STATS)
+    stats_begin(queue);
+#endif
+
+    for (uint32_t i = 0; i < queue->CommandCount; i++) {
+        queue->SortKeys[i] = make_sort_key(&queue->Commands[i], i);
+    }
+
+    qsort(queue->SortKeys, queue->CommandCount, sizeof(uint64_t), compare_sort_keys);
+
+    uint8_t currentBlend = BLEND_ALPHA;
+    bool paletteShader = false;
+
+    for (uint32_t i = 0; i < queue->CommandCount; i++) {
+        const RenderCommand* command = &queue->Commands[(uint32_t)queue->SortKeys[i]];
+
+        if (command->Blend != currentBlend) {
+            BeginBlendMode(command->Blend);
+            currentBlend = command->Blend;
+            STATS_SAMPLE(queue);
+        }
+
+        const bool indexed = command->Type == RENDER_CMD_INDEXED_SPRITE;
+        if (indexed != paletteShader) {
+            if (indexed) BeginShaderMode(queue->PaletteShader);
+            else EndShaderMode();
+            paletteShader = indexed;
+            STATS_SAMPLE(queue);
+        }
+
+        Color color = command->ColorIndex == RENDER_COLOR_WHITE ? WHITE : queue->Palette[command->ColorIndex];
+
+        switch (command->Type) {
+        case RENDER_CMD_RECT:
+            DrawRectangle(command->Dest.x, command->Dest.y, command->Dest.width, command->Dest.height, color);
+            STATS_COUNT(queue, Rectangles, 1);
+            break;
+        case RENDER_CMD_CIRCLE:
+            DrawCircle(command->Dest.x, command->Dest.y, command->Dest.width, color);
+            STATS_COUNT(queue, Circles, 1);
+            break;
+        case RENDER_CMD_SPRITE:
+            DrawTextureRec(queue->Textures[command->TextureIndex - 1], command->Source, (Vector2) { command->Dest.x, command->Dest.y }, color);
+            STATS_COUNT(queue, Sprites, 1);
+            break;
+        case RENDER_CMD_TEXT:
+            SetTextLineSpacing(command->LineSpacing);
+#if defined(SUPPORT_RENDER_STATS)
+            reserve_text(queue, command->Text);
+#endif
+            DrawText(command->Text, command->Dest.x, command->Dest.y, command->FontSize, color);
+            STATS_COUNT(queue, Texts, 1);
+            break;
+        case RENDER_CMD_QUADS:
+            draw_quads(queue, command, color);
+            STATS_COUNT(queue, Quads, command->QuadCount);
+            break;
+        case RENDER_CMD_INDEXED_SPRITE:
+            // rlgl forgets extra texture units whenever it flushes its batch, so bind the palette for every sprite
+            SetShaderValueTexture(queue->PaletteShader, queue->PaletteTextureLocation, queue->PaletteTexture);
+            DrawTextureRec(queue->Textures[command->TextureIndex - 1], command->Source, (Vector2) { command->Dest.x, command->Dest.y }, color);
+            STATS_COUNT(queue, Sprites, 1);
+            break;
+        default:
+            assert(false);
+            break;
+        }
+
+        STATS_SAMPLE(queue);
+    }
+
+    if (paletteShader) {
+        EndShaderMode();
+        STATS_SAMPLE(queue);
+    }
+
+    if (currentBlend != BLEND_ALPHA) {
+        EndBlendMode();
+        STATS_SAMPLE(queue);
+    }
+
+#if defined(SUPPORT_RENDER_STATS)
+    stats_end(queue);
+#endif
+
+    SetTextLineSpacing(DEFAULT_TEXT_LINE_SPACING);
+}
+
+void render_queue_set_blend_mode(RenderQueue* queue, BlendMode blendMode) {
+    queue->CurrentBlend = (uint8_t)blendMode;
+}
+
+// Swaps the palette for everything drawn by colour index, including indexed sprites, from the next submit on
+void render_queue_set_palette(RenderQueue* queue, Color* palette) {
+    queue->Palette = palette;
+
+    Color colors[RENDER_PALETTE_SIZE] = { 0 };
+    memcpy(colors, palette, queue->PaletteSize * sizeof(Color));
+
+    UpdateTexture(queue->PaletteTexture, colors);
+}
+
+void render_queue_rect(RenderQueue* queue, uint8_t layer, int posX, int posY, int width, int height, uint8_t colorIndex) {
+    RenderCommand* command = push_command(queue, RENDER_CMD_RECT, layer);
+    command->ColorIndex = colorIndex;
+    command->Dest = (Rectangle){ posX, posY, width, height };
+}
+
+void render_queue_circle(RenderQueue* queue, uint8_t layer, int centerX, int centerY, float radius, uint8_t colorIndex) {
+    RenderCommand* command = push_command(queue, RENDER_CMD_CIRCLE, layer);
+    command->ColorIndex = colorIndex;
+    command->Dest = (Rectangle){ centerX, centerY, radius, radius };
+}
+
+static void push_sprite(RenderQueue* queue, uint8_t type, uint8_t layer, Texture2D texture, Rectangle source, Vector2 position) {
+    const uint8_t textureIndex = texture_index(queue, texture);
+    if (textureIndex == 0) return;
+
+    RenderCommand* command = push_command(queue, type, layer);
+    command->ColorIndex = RENDER_COLOR_WHITE;
+    command->TextureIndex = textureIndex;
+    command->Dest = (Rectangle){ position.x, position.y, source.width, source.height };
+    command->Source = source;
+}
+
+void render_queue_sprite(RenderQueue* queue, uint8_t layer, Texture2D texture, Rectangle source, Vector2 position) {
+    push_sprite(queue, RENDER_CMD_SPRITE, layer, texture, source, position);
+}
+
+// texture holds palette indices (see convert_image_to_indices), drawn through the queue's palette
+void render_queue_indexed_sprite(RenderQueue* queue, uint8_t layer, Texture2D texture, Rectangle source, Vector2 position) {
+    push_sprite(queue, RENDER_CMD_INDEXED_SPRITE, layer, texture, source, position);
+}
+
+void render_queue_text(RenderQueue* queue, uint8_t layer, const char* text, int posX, int posY, int fontSize, int lineSpacing, uint8_t colorIndex) {
+    const uint8_t textureIndex = texture_index(queue, GetFontDefault().texture);
+    if (textureIndex == 0) return;
+
+    RenderCommand* command = push_command(queue, RENDER_CMD_TEXT, layer);
+    command->ColorIndex = colorIndex;
+    command->TextureIndex = textureIndex;
+    command->FontSize = (uint8_t)fontSize;
+    command->LineSpacing = (uint8_t)lineSpacing;
+    command->Dest = (Rectangle){ posX, posY, 0, 0 };
+    command->Text = text;
+}
+
+// Reserves count solid quads in screen space for the caller to fill in before the next render_queue_begin
+RenderQuads render_queue_quads(RenderQueue* queue, uint8_t layer, uint32_t count, uint8_t colorIndex) {
+    if (queue->QuadCount + count > queue->QuadCapacity) {
+        uint32_t newCapacity = queue->QuadCapacity * 2;
+        while (newCapacity < queue->QuadCount + count) newCapacity *= 2;
+
+        queue->QuadPositions = RL_REALLOC(queue->QuadPositions, newCapacity * sizeof(Vector2));
+        queue->QuadSizes = RL_REALLOC(queue->QuadSizes, newCapacity * sizeof(float));
+        queue->QuadCapacity = newCapacity;
+    }
+
+    RenderCommand* command = push_command(queue, RENDER_CMD_QUADS, layer);
+    command->ColorIndex = colorIndex;
+    command->FirstQuad = queue->QuadCount;
+    command->QuadCount = count;
+
+    queue->QuadCount += count;
+
+    return (RenderQuads){ queue->QuadPositions + command->FirstQuad, queue->QuadSizes + command->FirstQuad };
+}
+
+// Writes the commands of the last submitted frame in submission order, one per line, for render-cost analysis
+bool render_queue_save_capture(RenderQueue* queue, const char* fileName) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    static const char* typeNames[] = { "rect", "circle", "sprite", "text", "quads", "indexed" };
+
+    fprintf(file, "# commands: %u, textures: %u, quads: %u\n", queue->CommandCount, queue->TextureCount, queue->QuadCount);
+    fprintf(file, "# type;layer;blend;texture;color;x;y;w;h\n");
+
+    for (uint32_t i = 0; i < queue->CommandCount; i++) {
+        const RenderCommand* command = &queue->Commands[i];
+        unsigned int textureId = command->TextureIndex > 0 ? queue->Textures[command->TextureIndex - 1].id : 0;
+
+        fprintf(file, "%s;%u;%u;%u;%u;%.1f;%.1f;%.1f;%.1f\n", typeNames[command->Type], command->Layer, command->Blend, textureId, command->ColorIndex,
+            command->Dest.x, command->Dest.y, command->Dest.width, command->Dest.height);
+    }
+
+    fclose(file);
+
+    return true;
+}
@@ -0,0 +1,133 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <raylib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Draw call counters, only bench_render defines SUPPORT_RENDER_STATS. Submitting then goes through a
+// BatchCounter, which costs too much to leave on in debug builds.
+#if defined(SUPPORT_RENDER_STATS)
+    #include "batch_counter.h"
+#endif
+
+#define MAX_RENDER_TEXTURES 32
+#define RENDER_COLOR_WHITE 0xFF // Color index for untinted sprites
+#define RENDER_PALETTE_SIZE 256 // Entries in the palette texture, unused ones are transparent
+
+// Commands are sorted by layer first, then by blend mode and texture, then by submission order.
+// Draws within a layer may therefore be reordered if they use different textures.
+// Keep anything that has to stay in painter's order on its own layer (or on the same texture).
+typedef enum RenderLayer {
+    RENDER_LAYER_PARALLAX = 0, // + parallax layer index, up to MAX_PARALLAX_LAYERS
+    RENDER_LAYER_MENU_UI = 8, // the main menu UI sits behind the menu characters
+    RENDER_LAYER_MENU_UI_TEXT,
+    RENDER_LAYER_LEVEL,
+    RENDER_LAYER_BULLETS,
+    RENDER_LAYER_ENEMIES,
+    RENDER_LAYER_PORTALS,
+    RENDER_LAYER_PARTICLES,
+    RENDER_LAYER_CHARACTERS,
+    RENDER_LAYER_TETHER,
+    RENDER_LAYER_BLADESAWS,
+    RENDER_LAYER_UI,
+    RENDER_LAYER_UI_TEXT,
+    RENDER_LAYER_OVERLAY
+} RenderLayer;
+
+typedef enum RenderCommandType {
+    RENDER_CMD_RECT = 0,
+    RENDER_CMD_CIRCLE,
+    RENDER_CMD_SPRITE,
+    RENDER_CMD_TEXT,
+    RENDER_CMD_QUADS,
+    RENDER_CMD_INDEXED_SPRITE
+} RenderCommandType;
+
+typedef struct RenderCommand {
+    uint8_t Type;
+    uint8_t Layer;
+    uint8_t Blend;
+    uint8_t TextureIndex; // 0 is the shapes texture, otherwise index + 1 into RenderQueue.Textures
+    uint8_t ColorIndex; // Palette index or RENDER_COLOR_WHITE
+    uint8_t FontSize;
+    uint8_t LineSpacing;
+
+    Rectangle Dest; // rect: x, y, w, h. circle: center x, y and radius as width. sprite and text: x, y
+    Rectangle Source; // sprite only
+    const char* Text; // text only
+    uint32_t FirstQuad; // quads only, range in RenderQueue.QuadPositions and QuadSizes
+    uint32_t QuadCount;
+} RenderCommand;
+
+#if defined(SUPPORT_RENDER_STATS)
+// What the last render_queue_submit sent to the GPU. Draw calls, texture binds and flushes are measured
+// by StatsCounter, so texture, draw mode, blend and shader switches all show up the way rlgl handled them.
+typedef struct RenderStats {
+    uint32_t Commands;
+    uint32_t Rectangles; // DrawRectangle
+    uint32_t Circles; // DrawCircle
+    uint32_t Sprites; // DrawTextureRec, indexed sprites included
+    uint32_t Texts; // DrawText
+    uint32_t Quads; // Solid quads written straight into the batch
+    uint32_t TextureBinds;
+    uint32_t DrawCalls;
+    uint32_t BatchFlushes;
+} RenderStats;
+#endif
+
+// Quads reserved by render_queue_quads, top-left corner and edge length per quad
+typedef struct RenderQuads {
+    Vector2* Positions;
+    float* Sizes;
+} RenderQuads;
+
+typedef struct RenderQueue {
+    RenderCommand* Commands;
+    uint64_t* SortKeys;
+    uint32_t CommandCount;
+    uint32_t CommandCapacity;
+
+    // Solid square quads copied in by render_queue_quads, so the source data may change before submit.
+    // Same layout as particle emitters, both are written to rlgl by Particles_WriteQuads.
+    Vector2* QuadPositions;
+    float* QuadSizes;
+    uint32_t QuadCount;
+    uint32_t QuadCapacity;
+
+    Texture2D Textures[MAX_RENDER_TEXTURES];
+    uint8_t TextureCount;
+
+    Color* Palette;
+    Texture2D PaletteTexture; // Palette as a RENDER_PALETTE_SIZE x 1 texture, for indexed sprites
+    Shader PaletteShader;
+    int PaletteTextureLocation;
+    uint8_t PaletteSize;
+    uint8_t ClearColorIndex;
+    uint8_t CurrentBlend;
+
+#if defined(SUPPORT_RENDER_STATS)
+    RenderStats Stats;
+    BatchCounter StatsCounter;
+#endif
+} RenderQueue;
+
+void render_queue_init(RenderQueue* queue, Color* palette, uint8_t paletteSize);
+void render_queue_exit(RenderQueue* queue);
+
+void render_queue_begin(RenderQueue* queue, uint8_t clearColorIndex);
+void render_queue_submit(RenderQueue* queue);
+
+void render_queue_set_blend_mode(RenderQueue* queue, BlendMode blendMode);
+void render_queue_set_palette(RenderQueue* queue, Color* palette);
+
+void render_queue_rect(RenderQueue* queue, uint8_t layer, int posX, int posY, int width, int height, uint8_t colorIndex);
+void render_queue_circle(RenderQueue* queue, uint8_t layer, int centerX, int centerY, float radius, uint8_t colorIndex);
+void render_queue_sprite(RenderQueue* queue, uint8_t layer, Texture2D texture, Rectangle source, Vector2 position);
+void render_queue_indexed_sprite(RenderQueue* queue, uint8_t layer, Texture2D texture, Rectangle source, Vector2 position);
+void render_queue_text(RenderQueue* queue, uint8_t layer, const char* text, int posX, int posY, int fontSize, int lineSpacing, uint8_t colorIndex);
+RenderQuads render_queue_quads(RenderQueue* queue, uint8_t layer, uint32_t count, uint8_t colorIndex);
+
+bool render_queue_save_capture(RenderQueue* queue, const char* fileName);
+
+#endif
@@ -0,0 +1,114 @@
+#include "sim_thread.h"
+#include "profiler.h"
+
+#include <assert.h>
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+    #define SUPPORT_SIM_THREAD
+#endif
+
+#if defined(SUPPORT_SIM_THREAD)
+static void sim_thread_main(void* arg) {
+	SimThread* sim = (SimThread*)arg;
+
+	PROFILE_THREAD_NAME("sim");
+
+	mutex_lock(sim->Lock);
+
+	while (true) {
+		while (!sim->Pending && !sim->Quit) {
+			condvar_wait(sim->WorkReady, sim->Lock);
+		}
+
+		if (sim->Quit) break;
+
+		mutex_unlock(sim->Lock);
+		PROFILE_BEGIN(PROFILE_ZONE_GAME_TICK);
+		game_tick(sim->Game, sim->Level, &sim->Input, sim->ScreenWidth, sim->ScreenHeight, sim->Dt);
+		PROFILE_END(PROFILE_ZONE_GAME_TICK);
+		mutex_lock(sim->Lock);
+
+		sim->Pending = false;
+		condvar_signal(sim->WorkDone);
+	}
+
+	mutex_unlock(sim->Lock);
+}
+#endif
+
+void sim_thread_init(SimThread* sim) {
+	memset(sim, 0, sizeof(SimThread));
+
+#if defined(SUPPORT_SIM_THREAD)
+	sim->Lock = mutex_create();
+	sim->WorkReady = condvar_create();
+	sim->WorkDone = condvar_create();
+	sim->Worker = thread_create(sim_thread_main, sim);
+	// If the thread can't be created, sim_thread_kick falls back to ticking inline
+#endif
+}
+
+void sim_thread_exit(SimThread* sim) {
+#if defined(SUPPORT_SIM_THREAD)
+	if (sim->Worker != NULL) {
+		mutex_lock(sim->Lock);
+		sim->Quit = true;
+		condvar_signal(sim->WorkReady);
+		mutex_unlock(sim->Lock);
+
+		thread_join(sim->Worker);
+		sim->Worker = NULL;
+	}
+
+	condvar_destroy(sim->WorkDone);
+	condvar_destroy(sim->WorkReady);
+	mutex_destroy(sim->Lock);
+#else
+	(void)sim;
+#endif
+}
+
+void sim_thread_kick(SimThread* sim, GameData* gameData, const LevelData* levelData, GameInput input, int screenWidth, int screenHeight, float dt) {
+#if defined(SUPPORT_SIM_THREAD)
+	if (sim->Worker != NULL) {
+		mutex_lock(sim->Lock);
+		assert(!sim->Pending); // Only one frame of pipelining
+
+		sim->Game = gameData;
+		sim->Level = levelData;
+		sim->Input = input;
+		sim->ScreenWidth = screenWidth;
+		sim->ScreenHeight = screenHeight;
+		sim->Dt = dt;
+		sim->Pending = true;
+
+		condvar_signal(sim->WorkReady);
+		mutex_unlock(sim->Lock);
+
+		return;
+	}
+#else
+	(void)sim;
+#endif
+
+	PROFILE_BEGIN(PROFILE_ZONE_GAME_TICK);
+	game_tick(gameData, levelData, &input, screenWidth, screenHeight, dt);
+	PROFILE_END(PROFILE_ZONE_GAME_TICK);
+}
+
+void sim_thread_join(SimThread* sim) {
+#if defined(SUPPORT_SIM_THREAD)
+	if (sim->Worker == NULL) return;
+
+	mutex_lock(sim->Lock);
+
+	while (sim->Pending) {
+		condvar_wait(sim->WorkDone, sim->Lock);
+	}
+
+	mutex_unlock(sim->Lock);
+#else
+	(void)sim;
+#endif
+}
@@ -0,0 +1,40 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include <raylib.h>
+#include <stdbool.h>
+
+#include "game.h"
+#include "threading.h"
+
+// Runs game_tick for the next frame on a worker thread while the main thread submits the
+// render commands of the current frame. At most one tick is ever in flight: sim_thread_join
+// has to be called before the main thread touches GameData again, so latency stays bounded
+// to a single frame of pipelining.
+// GameData is not double-buffered. The render queue recorded before sim_thread_kick is the snapshot
+// of the frame on screen, it copies everything it needs. So game_draw still runs before the tick,
+// only submitting the queue overlaps with it.
+// On PLATFORM_WEB (no pthreads) the tick simply runs inline in sim_thread_kick.
+typedef struct SimThread {
+	Thread* Worker;
+	Mutex* Lock;
+	CondVar* WorkReady;
+	CondVar* WorkDone;
+
+	bool Pending;
+	bool Quit;
+
+	GameData* Game;
+	const LevelData* Level;
+	GameInput Input;
+	int ScreenWidth;
+	int ScreenHeight;
+	float Dt;
+} SimThread;
+
+void sim_thread_init(SimThread* sim);
+void sim_thread_exit(SimThread* sim);
+void sim_thread_kick(SimThread* sim, GameData* gameData, const LevelData* levelData, GameInput input, int screenWidth, int screenHeight, float dt);
+void sim_thread_join(SimThread* sim);
+
+#endif
@@ -0,0 +1,114 @@
+#include "sound_pool.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "asset_loader.h"
+
+void sound_pool_init(SoundPool* pool) {
+	memset(pool, 0, sizeof(SoundPool));
+}
+
+void sound_pool_exit(SoundPool* pool) {
+	for (uint8_t i = 0; i < pool->SampleCount; i++) {
+		SoundSample* sample = &pool->Samples[i];
+
+		for (int v = 0; v < SOUND_VOICES_PER_SAMPLE; v++) {
+			UnloadSoundAlias(sample->Voices[v].Alias);
+		}
+
+		UnloadSound(sample->Source);
+	}
+
+	memset(pool, 0, sizeof(SoundPool));
+}
+
+uint8_t sound_pool_add_effect(SoundPool* pool, const char** paths, uint8_t pathCount, float minInterval, bool restart) {
+	assert(pool->EffectCount < MAX_SOUND_EFFECTS);
+	assert(pool->SampleCount + pathCount <= MAX_SOUND_SAMPLES);
+
+	SoundEffect* effect = &pool->Effects[pool->EffectCount];
+	effect->FirstSample = pool->SampleCount;
+	effect->SampleCount = pathCount;
+	effect->Restart = restart;
+	effect->MinInterval = minInterval;
+	effect->LastPlayTime = -minInterval;
+
+	for (uint8_t i = 0; i < pathCount; i++) {
+		SoundSample* sample = &pool->Samples[pool->SampleCount];
+		sample->Source = asset_sound_load(paths[i]);
+		sample->Duration = sample->Source.stream.sampleRate > 0 ? (float)sample->Source.frameCount / sample->Source.stream.sampleRate : 0.0f;
+
+		for (int v = 0; v < SOUND_VOICES_PER_SAMPLE; v++) {
+			sample->Voices[v].Alias = LoadSoundAlias(sample->Source);
+			sample->Voices[v].EndTime = 0.0;
+		}
+
+		pool->SampleCount += 1;
+	}
+
+	pool->EffectCount += 1;
+
+	return pool->EffectCount - 1;
+}
+
+static int active_voice_count(const SoundPool* pool, double now) {
+	int count = 0;
+
+	for (uint8_t i = 0; i < pool->SampleCount; i++) {
+		for (int v = 0; v < SOUND_VOICES_PER_SAMPLE; v++) {
+			if (pool->Samples[i].Voices[v].EndTime > now) count++;
+		}
+	}
+
+	return count;
+}
+
+static void play_effect(SoundPool* pool, SoundEffect* effect, double now) {
+	if (now - effect->LastPlayTime < effect->MinInterval) return;
+
+	if (!effect->Restart) {
+		for (uint8_t i = 0; i < effect->SampleCount; i++) {
+			for (int v = 0; v < SOUND_VOICES_PER_SAMPLE; v++) {
+				if (pool->Samples[effect->FirstSample + i].Voices[v].EndTime > now) return;
+			}
+		}
+	}
+
+	SoundSample* sample = &pool->Samples[effect->FirstSample + GetRandomValue(0, effect->SampleCount - 1)];
+
+	// A free voice of this sample, or the one that ends first
+	SoundVoice* voice = &sample->Voices[0];
+	for (int v = 1; v < SOUND_VOICES_PER_SAMPLE; v++) {
+		if (sample->Voices[v].EndTime < voice->EndTime) voice = &sample->Voices[v];
+	}
+
+	// Restarting a busy voice doesn't add to the mix
+	if (voice->EndTime <= now && active_voice_count(pool, now) >= MAX_ACTIVE_VOICES) return;
+
+	PlaySound(voice->Alias);
+	voice->EndTime = now + sample->Duration;
+	effect->LastPlayTime = now;
+}
+
+void sound_pool_play(SoundPool* pool, SoundEventQueue* queue) {
+	const double now = GetTime();
+
+	for (uint8_t i = 0; i < queue->Count; i++) {
+		assert(queue->Events[i] < pool->EffectCount);
+		play_effect(pool, &pool->Effects[queue->Events[i]], now);
+	}
+
+	queue->Count = 0;
+}
+
+void sound_event_push(SoundEventQueue* queue, uint8_t effect) {
+	for (uint8_t i = 0; i < queue->Count; i++) {
+		if (queue->Events[i] == effect) return;
+	}
+
+	if (queue->Count < MAX_SOUND_EVENTS) {
+		queue->Events[queue->Count] = effect;
+		queue->Count += 1;
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef SOUND_POOL_H
+#define SOUND_POOL_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sound effects played through a fixed pool of voices.
+// Every sample is loaded once and aliased (LoadSoundAlias) into SOUND_VOICES_PER_SAMPLE voices, so the
+// same sample can overlap itself without reloading. At most MAX_ACTIVE_VOICES voices are mixed at a time,
+// requests beyond that are dropped. Voice lifetimes are tracked from the sample length, not by polling
+// the audio device.
+// Gameplay code pushes effect ids into a SoundEventQueue (no audio calls, so it works on the sim thread),
+// the main thread plays the queue once per frame. The same effect pushed twice in a frame plays once.
+
+#define MAX_SOUND_SAMPLES 8
+#define MAX_SOUND_EFFECTS 8
+#define MAX_SOUND_EVENTS 16
+#define SOUND_VOICES_PER_SAMPLE 3
+#define MAX_ACTIVE_VOICES 8
+
+typedef struct SoundVoice {
+	Sound Alias;
+	double EndTime;
+} SoundVoice;
+
+typedef struct SoundSample {
+	Sound Source;
+	float Duration;
+	SoundVoice Voices[SOUND_VOICES_PER_SAMPLE];
+} SoundSample;
+
+typedef struct SoundEffect {
+	uint8_t FirstSample; // Plays one of SampleCount samples at random
+	uint8_t SampleCount;
+	bool Restart; // Overlaps itself and restarts the oldest voice when all are busy, otherwise plays through before playing again
+	float MinInterval; // Seconds between two plays of this effect
+	double LastPlayTime;
+} SoundEffect;
+
+typedef struct SoundPool {
+	SoundSample Samples[MAX_SOUND_SAMPLES];
+	uint8_t SampleCount;
+	SoundEffect Effects[MAX_SOUND_EFFECTS];
+	uint8_t EffectCount;
+} SoundPool;
+
+typedef struct SoundEventQueue {
+	uint8_t Events[MAX_SOUND_EVENTS];
+	uint8_t Count;
+} SoundEventQueue;
+
+void sound_pool_init(SoundPool* pool);
+void sound_pool_exit(SoundPool* pool);
+
+// Returns the effect id to push
+uint8_t sound_pool_add_effect(SoundPool* pool, const char** paths, uint8_t pathCount, float minInterval, bool restart);
+void sound_pool_play(SoundPool* pool, SoundEventQueue* queue); // Plays and clears the queue, main thread only
+
+void sound_event_push(SoundEventQueue* queue, uint8_t effect);
+
+#endif
@@ -0,0 +1,113 @@
+#include "sprite_cache.h"
+#include "profiler.h"
+
+#include <assert.h>
+#include <string.h>
+
+void sprite_cache_init(SpriteCache* cache) {
+	memset(cache, 0, sizeof(SpriteCache));
+}
+
+void sprite_cache_exit(SpriteCache* cache) {
+	for (int i = 0; i < cache->ScaleCount; i++) {
+		UnloadTexture(cache->Scales[i].Textures[0]);
+		UnloadTexture(cache->Scales[i].Textures[1]);
+	}
+
+	for (int i = 0; i < cache->SourceCount; i++) {
+		UnloadImage(cache->Sources[i]);
+	}
+
+	memset(cache, 0, sizeof(SpriteCache));
+}
+
+// ImageResizeNN goes through RGBA and back, which rounds some grayscale values down by one.
+// Indexed sheets are grayscale palette indices that have to stay exact, so those are scaled here.
+static void resize_nearest(Image* image, int width, int height) {
+	if (image->format != PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) {
+		ImageResizeNN(image, width, height);
+		return;
+	}
+
+	// Same 16.16 stepping as ImageResizeNN, so both pick the same texels
+	const int xRatio = (image->width << 16) / width + 1;
+	const int yRatio = (image->height << 16) / height + 1;
+
+	const unsigned char* source = (const unsigned char*)image->data;
+	unsigned char* scaled = RL_MALLOC(width * height);
+
+	for (int y = 0; y < height; y++) {
+		const unsigned char* row = source + ((y * yRatio) >> 16) * image->width;
+
+		for (int x = 0; x < width; x++) {
+			scaled[y * width + x] = row[(x * xRatio) >> 16];
+		}
+	}
+
+	RL_FREE(image->data);
+	image->data = scaled;
+	image->width = width;
+	image->height = height;
+}
+
+int sprite_cache_add_source(SpriteCache* cache, Image image) {
+	assert(cache->SourceCount < MAX_SPRITE_SOURCES);
+
+	cache->Sources[cache->SourceCount] = image;
+	cache->SourceCount += 1;
+
+	return cache->SourceCount - 1;
+}
+
+const Texture2D* sprite_cache_get(SpriteCache* cache, int source, int width, int height) {
+	assert(source >= 0 && source < cache->SourceCount);
+
+	cache->UseCounter += 1;
+
+	for (int i = 0; i < cache->ScaleCount; i++) {
+		SpriteScale* scale = &cache->Scales[i];
+
+		if (scale->Source == source && scale->Width == width && scale->Height == height) {
+			scale->LastUse = cache->UseCounter;
+			return scale->Textures;
+		}
+	}
+
+	SpriteScale* scale = NULL;
+
+	if (cache->ScaleCount < MAX_SPRITE_SCALES) {
+		scale = &cache->Scales[cache->ScaleCount];
+		cache->ScaleCount += 1;
+	}
+	else {
+		scale = &cache->Scales[0];
+
+		for (int i = 1; i < cache->ScaleCount; i++) {
+			if (cache->Scales[i].LastUse < scale->LastUse) scale = &cache->Scales[i];
+		}
+
+		UnloadTexture(scale->Textures[0]);
+		UnloadTexture(scale->Textures[1]);
+	}
+
+	PROFILE_SLICE_BEGIN("sprite_scale");
+	PROFILE_SLICE_ARG("width", width);
+	PROFILE_SLICE_ARG("height", height);
+
+	Image scaled = ImageCopy(cache->Sources[source]);
+	resize_nearest(&scaled, width, height);
+	scale->Textures[0] = LoadTextureFromImage(scaled);
+
+	ImageFlipVertical(&scaled);
+	scale->Textures[1] = LoadTextureFromImage(scaled);
+
+	UnloadImage(scaled);
+	PROFILE_SLICE_END();
+
+	scale->Source = source;
+	scale->Width = width;
+	scale->Height = height;
+	scale->LastUse = cache->UseCounter;
+
+	return scale->Textures;
+}
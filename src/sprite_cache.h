@@ -0,0 +1,40 @@
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+#include <raylib.h>
+#include <stdint.h>
+
+// Pixel art sprite sheets at whatever size the tile size asks for.
+// Sources stay on the CPU at their original resolution and are scaled with nearest neighbour, so texels
+// stay crisp (integer factors give exact integer scaling). Every (source, size) pair is scaled and
+// uploaded once, later requests for it are a lookup. When all slots are taken the least recently
+// requested size is unloaded.
+// Indexed sources (grayscale palette indices) scale to indexed textures, draw them as indexed sprites.
+
+#define MAX_SPRITE_SOURCES 8
+#define MAX_SPRITE_SCALES 32
+
+typedef struct SpriteScale {
+	int Source;
+	int Width;
+	int Height;
+	Texture2D Textures[2]; // As loaded and vertically flipped
+	uint32_t LastUse;
+} SpriteScale;
+
+typedef struct SpriteCache {
+	Image Sources[MAX_SPRITE_SOURCES];
+	int SourceCount;
+
+	SpriteScale Scales[MAX_SPRITE_SCALES];
+	int ScaleCount;
+	uint32_t UseCounter;
+} SpriteCache;
+
+void sprite_cache_init(SpriteCache* cache);
+void sprite_cache_exit(SpriteCache* cache);
+
+int sprite_cache_add_source(SpriteCache* cache, Image image); // Takes ownership of image, returns the source index
+const Texture2D* sprite_cache_get(SpriteCache* cache, int source, int width, int height); // Normal and flipped texture
+
+#endif
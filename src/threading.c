@@ -0,0 +1,207 @@
+#include "threading.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+
+struct Thread {
+    HANDLE Handle;
+    void (*Func)(void*);
+    void* Arg;
+};
+
+struct Mutex {
+    CRITICAL_SECTION Section;
+};
+
+struct CondVar {
+    CONDITION_VARIABLE Variable;
+};
+
+static DWORD WINAPI thread_entry(LPVOID param) {
+    Thread* thread = (Thread*)param;
+    thread->Func(thread->Arg);
+    return 0;
+}
+
+Thread* thread_create(void (*func)(void*), void* arg) {
+    Thread* thread = calloc(1, sizeof(Thread));
+    thread->Func = func;
+    thread->Arg = arg;
+    thread->Handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+
+    if (thread->Handle == NULL) {
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void thread_join(Thread* thread) {
+    WaitForSingleObject(thread->Handle, INFINITE);
+    CloseHandle(thread->Handle);
+    free(thread);
+}
+
+Mutex* mutex_create(void) {
+    Mutex* mutex = calloc(1, sizeof(Mutex));
+    InitializeCriticalSection(&mutex->Section);
+    return mutex;
+}
+
+void mutex_destroy(Mutex* mutex) {
+    DeleteCriticalSection(&mutex->Section);
+    free(mutex);
+}
+
+void mutex_lock(Mutex* mutex) {
+    EnterCriticalSection(&mutex->Section);
+}
+
+void mutex_unlock(Mutex* mutex) {
+    LeaveCriticalSection(&mutex->Section);
+}
+
+CondVar* condvar_create(void) {
+    CondVar* condVar = calloc(1, sizeof(CondVar));
+    InitializeConditionVariable(&condVar->Variable);
+    return condVar;
+}
+
+void condvar_destroy(CondVar* condVar) {
+    free(condVar);
+}
+
+void condvar_wait(CondVar* condVar, Mutex* mutex) {
+    SleepConditionVariableCS(&condVar->Variable, &mutex->Section, INFINITE);
+}
+
+void condvar_signal(CondVar* condVar) {
+    WakeConditionVariable(&condVar->Variable);
+}
+
+void condvar_broadcast(CondVar* condVar) {
+    WakeAllConditionVariable(&condVar->Variable);
+}
+
+int thread_get_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+double thread_get_time(void) {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+int atomic_increment(volatile int* value) {
+    return (int)InterlockedIncrement((volatile LONG*)value);
+}
+
+#else
+    #include <pthread.h>
+    #include <time.h>
+    #include <unistd.h>
+
+struct Thread {
+    pthread_t Handle;
+    void (*Func)(void*);
+    void* Arg;
+};
+
+struct Mutex {
+    pthread_mutex_t Handle;
+};
+
+struct CondVar {
+    pthread_cond_t Handle;
+};
+
+static void* thread_entry(void* param) {
+    Thread* thread = (Thread*)param;
+    thread->Func(thread->Arg);
+    return NULL;
+}
+
+Thread* thread_create(void (*func)(void*), void* arg) {
+    Thread* thread = calloc(1, sizeof(Thread));
+    thread->Func = func;
+    thread->Arg = arg;
+
+    if (pthread_create(&thread->Handle, NULL, thread_entry, thread) != 0) {
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void thread_join(Thread* thread) {
+    pthread_join(thread->Handle, NULL);
+    free(thread);
+}
+
+Mutex* mutex_create(void) {
+    Mutex* mutex = calloc(1, sizeof(Mutex));
+    pthread_mutex_init(&mutex->Handle, NULL);
+    return mutex;
+}
+
+void mutex_destroy(Mutex* mutex) {
+    pthread_mutex_destroy(&mutex->Handle);
+    free(mutex);
+}
+
+void mutex_lock(Mutex* mutex) {
+    pthread_mutex_lock(&mutex->Handle);
+}
+
+void mutex_unlock(Mutex* mutex) {
+    pthread_mutex_unlock(&mutex->Handle);
+}
+
+CondVar* condvar_create(void) {
+    CondVar* condVar = calloc(1, sizeof(CondVar));
+    pthread_cond_init(&condVar->Handle, NULL);
+    return condVar;
+}
+
+void condvar_destroy(CondVar* condVar) {
+    pthread_cond_destroy(&condVar->Handle);
+    free(condVar);
+}
+
+void condvar_wait(CondVar* condVar, Mutex* mutex) {
+    pthread_cond_wait(&condVar->Handle, &mutex->Handle);
+}
+
+void condvar_signal(CondVar* condVar) {
+    pthread_cond_signal(&condVar->Handle);
+}
+
+void condvar_broadcast(CondVar* condVar) {
+    pthread_cond_broadcast(&condVar->Handle);
+}
+
+int thread_get_cpu_count(void) {
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+double thread_get_time(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+int atomic_increment(volatile int* value) {
+    return __sync_add_and_fetch(value, 1);
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef THREADING_H
+#define THREADING_H
+
+// Minimal portable threading primitives (Win32 or pthreads).
+// Kept out of raylib.h on purpose: windows.h and raylib.h can't be included in the same file.
+
+typedef struct Thread Thread;
+typedef struct Mutex Mutex;
+typedef struct CondVar CondVar;
+
+Thread* thread_create(void (*func)(void*), void* arg);
+void thread_join(Thread* thread);
+
+Mutex* mutex_create(void);
+void mutex_destroy(Mutex* mutex);
+void mutex_lock(Mutex* mutex);
+void mutex_unlock(Mutex* mutex);
+
+CondVar* condvar_create(void);
+void condvar_destroy(CondVar* condVar);
+void condvar_wait(CondVar* condVar, Mutex* mutex);
+void condvar_signal(CondVar* condVar);
+void condvar_broadcast(CondVar* condVar);
+
+int thread_get_cpu_count(void);
+double thread_get_time(void);     // Monotonic wall clock in seconds, for timing threaded work
+
+int atomic_increment(volatile int* value); // Returns the incremented value
+
+#endif